@@ -13,9 +13,153 @@ This program demonstrates: Classes, Arrays (Vectors), File Handling
 #include <vector>         // For dynamic arrays (vector) - ARRAYS CONCEPT
 #include <iomanip>        // For output formatting (setw, setprecision)
 #include <ctime>          // For time functions (time, ctime)
+#include <chrono>         // For benchmark timing
+#include <cstdlib>        // For atoi
+#include <algorithm>      // For min, max
+#include <cstdint>        // For fixed-width integers (uint8_t, uint64_t)
+#include <cstring>        // For memcpy
+#include <random>         // For benchmark data
+#include <cerrno>         // For errno (EINTR)
+#include <cstdio>         // For rename
+#include <fcntl.h>        // For open - binary data file
+#include <sys/mman.h>     // For mmap - binary data file
+#include <sys/stat.h>     // For fstat
+#include <unistd.h>       // For write, fdatasync, close, unlink
+#include <thread>         // For background log compaction
+#include <atomic>         // For the compaction result
+#include <sstream>        // For ostringstream
+#include <cctype>         // For toupper, isalpha - scan parsing
+#include "../../COMMON/console_output.h"  // Buffered cout, quiet reports
 
 using namespace std;      // Standard namespace to avoid std:: prefix
 
+// ============================================================
+// CLASSES CONCEPT - AttendanceBitmap Class Definition
+// ============================================================
+
+// One bit per class day: bit d is set when the student attended day d
+// (days counted from 0). Bits are packed eight to a byte, so a semester of
+// 200 days costs 25 bytes per student, and counts over any range of days
+// are population counts of whole 64-bit words.
+class AttendanceBitmap {
+private:
+    vector<uint8_t> bits;   // Day d lives in bits[d / 8], bit d % 8
+    int days;               // Class days recorded so far
+
+    static int popcount(uint64_t word) { return __builtin_popcountll(word); }
+
+public:
+    AttendanceBitmap() : days(0) {}
+
+    int size() const { return days; }
+    size_t byteSize() const { return bits.size(); }
+    const uint8_t* data() const { return bits.data(); }
+
+    // Take `count` days packed as by data(); false if bits are set past
+    // the last day (a damaged record)
+    bool assign(const uint8_t* packed, int count) {
+        size_t byteCount = (static_cast<size_t>(count) + 7) / 8;
+        if (count < 0 || (count % 8 != 0 && (packed[byteCount - 1] >> (count % 8)) != 0)) {
+            return false;
+        }
+        bits.assign(packed, packed + byteCount);
+        days = count;
+        return true;
+    }
+
+    // Record the next class day
+    void append(bool present) {
+        if (days % 8 == 0) {
+            bits.push_back(0);
+        }
+        days++;
+        set(days - 1, present);
+    }
+
+    // Record `count` more class days, all absent
+    void appendAbsent(int count) {
+        days += count;
+        bits.resize((static_cast<size_t>(days) + 7) / 8, 0);  // Bits past the end stay clear
+    }
+
+    bool get(int day) const {
+        return day >= 0 && day < days && (bits[day / 8] >> (day % 8)) & 1;
+    }
+
+    // Correct an already recorded day
+    void set(int day, bool present) {
+        if (day < 0 || day >= days) {
+            return;
+        }
+        uint8_t mask = static_cast<uint8_t>(1u << (day % 8));
+        bits[day / 8] = present ? bits[day / 8] | mask : bits[day / 8] & ~mask;
+    }
+
+    // POPCOUNT: Days attended in [first, last), clamped to recorded days
+    // Partial bytes at both ends are masked, whole bytes in between are
+    // counted eight at a time
+    int countPresent(int first, int last) const {
+        if (first < 0) first = 0;
+        if (last > days) last = days;
+        if (first >= last) {
+            return 0;
+        }
+        size_t firstByte = static_cast<size_t>(first) / 8;
+        size_t lastByte = static_cast<size_t>(last - 1) / 8;
+        uint8_t headMask = static_cast<uint8_t>(0xFF << (first % 8));
+        uint8_t tailMask = static_cast<uint8_t>(0xFF >> (7 - (last - 1) % 8));
+        if (firstByte == lastByte) {
+            return popcount(bits[firstByte] & headMask & tailMask);
+        }
+        int count = popcount(bits[firstByte] & headMask) + popcount(bits[lastByte] & tailMask);
+        size_t i = firstByte + 1;
+        for (; i + 8 <= lastByte; i += 8) {
+            uint64_t word;
+            memcpy(&word, &bits[i], sizeof(word));
+            count += popcount(word);
+        }
+        for (; i < lastByte; i++) {
+            count += popcount(bits[i]);
+        }
+        return count;
+    }
+
+    int countPresent() const { return countPresent(0, days); }
+
+    // FILE HANDLING: Two hex digits per byte, "-" when no days are recorded
+    string toHex() const {
+        static const char DIGITS[] = "0123456789abcdef";
+        if (bits.empty()) {
+            return "-";
+        }
+        string text;
+        text.reserve(bits.size() * 2);
+        for (uint8_t byte : bits) {
+            text += DIGITS[byte >> 4];
+            text += DIGITS[byte & 15];
+        }
+        return text;
+    }
+
+    // Parse toHex() output holding `count` days; false if it does not fit
+    bool fromHex(const string& text, int count) {
+        size_t byteCount = (static_cast<size_t>(count) + 7) / 8;
+        if (count < 0 || (count == 0 ? text != "-" : text.size() != byteCount * 2)) {
+            return false;
+        }
+        vector<uint8_t> parsed(byteCount);
+        for (size_t i = 0; i < text.size() && count > 0; i++) {
+            char c = text[i];
+            int digit = c >= '0' && c <= '9' ? c - '0' : c >= 'a' && c <= 'f' ? c - 'a' + 10 : -1;
+            if (digit < 0) {
+                return false;
+            }
+            parsed[i / 2] = static_cast<uint8_t>(parsed[i / 2] << 4 | digit);
+        }
+        return assign(parsed.data(), count);
+    }
+};
+
 // ============================================================
 // CLASSES CONCEPT - Student Class Definition
 // ============================================================
@@ -25,49 +169,65 @@ using namespace std;      // Standard namespace to avoid std:: prefix
 class Student {
 private:
     // PRIVATE DATA MEMBERS - Encapsulation principle
-    int id;                // Student ID
-    string name;           // Student name
-    int totalClasses;      // Total classes held
-    int attendedClasses;   // Classes attended by student
+    int id;                      // Student ID
+    string name;                 // Student name
+    AttendanceBitmap attendance; // One bit per class day held
 
 public:
     // CONSTRUCTOR - Initializes object when created
     // Demonstrates: CONSTRUCTOR OVERLOADING (with default parameters)
+    // Counts without per-day history (old data files) are recorded as the
+    // first `attended` days present and the rest absent
     Student(int studentId = 0, string studentName = "", int classes = 0, int attended = 0) {
         id = studentId;
         name = studentName;
-        totalClasses = classes;
-        attendedClasses = attended;
+        for (int day = 0; day < classes; day++) {
+            attendance.append(day < attended);
+        }
     }
 
     // GETTER METHODS - Provide controlled access to private data
     // Demonstrates: ACCESSOR METHODS (const ensures they don't modify object)
     int getId() const { return id; }
     string getName() const { return name; }
-    int getTotalClasses() const { return totalClasses; }
-    int getAttendedClasses() const { return attendedClasses; }
+    int getTotalClasses() const { return attendance.size(); }
+    int getAttendedClasses() const { return attendance.countPresent(); }
+    const AttendanceBitmap& getAttendance() const { return attendance; }
 
     // SETTER METHODS - Provide controlled modification of private data
     // Demonstrates: MUTATOR METHODS
     void setId(int studentId) { id = studentId; }
     void setName(string studentName) { name = studentName; }
-    void setTotalClasses(int classes) { totalClasses = classes; }
-    void setAttendedClasses(int attended) { attendedClasses = attended; }
+    void setAttendance(const AttendanceBitmap& days) { attendance = days; }
+    bool setAttendance(const uint8_t* packed, int days) { return attendance.assign(packed, days); }
+
+    // Correct the record of one class day (0-based), e.g. after an audit
+    void setPresent(int day, bool present) { attendance.set(day, present); }
+    bool wasPresent(int day) const { return attendance.get(day); }
 
     // Calculate attendance percentage
     // Demonstrates: MEMBER FUNCTION, TYPE CASTING
     double getAttendancePercentage() const {
-        if (totalClasses == 0) return 0.0;
-        return (static_cast<double>(attendedClasses) / totalClasses) * 100.0;
+        return getAttendancePercentage(0, attendance.size());
+    }
+
+    // Attendance percentage over class days [first, last)
+    double getAttendancePercentage(int first, int last) const {
+        if (first < 0) first = 0;
+        if (last > attendance.size()) last = attendance.size();
+        if (first >= last) return 0.0;
+        return (static_cast<double>(attendance.countPresent(first, last)) / (last - first)) * 100.0;
     }
 
     // Mark attendance for a class
     // Demonstrates: MODIFYING MEMBER DATA
     void markAttendance(bool present) {
-        totalClasses++;            // Increment total classes
-        if (present) {
-            attendedClasses++;     // Increment attended if present
-        }
+        attendance.append(present);  // One more class day, present or not
+    }
+
+    // Add `count` class days at once, all absent (bulk imports)
+    void markAbsentDays(int count) {
+        attendance.appendAbsent(count);
     }
 
     // Display student information
@@ -75,12 +235,800 @@ public:
     void display() const {
         cout << left << setw(10) << id 
              << setw(25) << name 
-             << setw(15) << totalClasses 
-             << setw(15) << attendedClasses 
-             << setw(15) << fixed << setprecision(2) << getAttendancePercentage() << "%" << endl;
+             << setw(15) << getTotalClasses() 
+             << setw(15) << getAttendedClasses() 
+             << setw(15) << fixed << setprecision(2) << getAttendancePercentage() << "%\n";
     }
 };
 
+// ============================================================
+// HASH INDEX - Student ID to position in the students vector
+// ============================================================
+
+// Open-addressing hash map from student ID to slot. Lookups and duplicate
+// checks cost O(1) on average instead of a scan over every student.
+class StudentIndex {
+private:
+    struct Entry {
+        int id;
+        uint32_t slot;      // Position in AttendanceSystem::students, NOT_FOUND if empty
+    };
+
+    vector<Entry> table;    // Power-of-two sized, linear probing
+    size_t count;
+    unsigned shift;         // 64 - log2(table size), for Fibonacci hashing
+
+    size_t bucketFor(int id) const {
+        uint64_t key = static_cast<uint32_t>(id);
+        return static_cast<size_t>((key * 0x9E3779B97F4A7C15ULL) >> shift);
+    }
+
+    // Double the table and re-insert every entry
+    void grow() {
+        vector<Entry> old;
+        old.swap(table);
+        table.assign(old.size() * 2, Entry{0, NOT_FOUND});
+        shift--;
+        for (const auto& entry : old) {
+            if (entry.slot != NOT_FOUND) {
+                size_t i = bucketFor(entry.id);
+                while (table[i].slot != NOT_FOUND) {
+                    i = (i + 1) & (table.size() - 1);
+                }
+                table[i] = entry;
+            }
+        }
+    }
+
+public:
+    static const uint32_t NOT_FOUND = UINT32_MAX;
+
+    StudentIndex() : table(8, Entry{0, NOT_FOUND}), count(0), shift(61) {}
+
+    size_t size() const { return count; }
+
+    void clear() {
+        table.assign(8, Entry{0, NOT_FOUND});
+        count = 0;
+        shift = 61;
+    }
+
+    // Pre-size the table so that bulk loads do not rehash
+    void reserve(size_t students) {
+        while (students * 10 > table.size() * 7) {
+            grow();
+        }
+    }
+
+    // Insert a new mapping, returns false if the ID already exists
+    bool insert(int id, uint32_t slot) {
+        if ((count + 1) * 10 > table.size() * 7) {  // Keep load factor under 70%
+            grow();
+        }
+        size_t i = bucketFor(id);
+        while (table[i].slot != NOT_FOUND) {
+            if (table[i].id == id) {
+                return false;
+            }
+            i = (i + 1) & (table.size() - 1);
+        }
+        table[i] = Entry{id, slot};
+        count++;
+        return true;
+    }
+
+    // Find the slot of a student, NOT_FOUND if the ID does not exist
+    uint32_t find(int id) const {
+        size_t i = bucketFor(id);
+        while (table[i].slot != NOT_FOUND) {
+            if (table[i].id == id) {
+                return table[i].slot;
+            }
+            i = (i + 1) & (table.size() - 1);
+        }
+        return NOT_FOUND;
+    }
+
+    // Remove an ID (for deleting students); later entries of the probe
+    // chain are shifted back, so no tombstones are needed
+    bool erase(int id) {
+        size_t mask = table.size() - 1;
+        size_t i = bucketFor(id);
+        while (table[i].slot != NOT_FOUND && table[i].id != id) {
+            i = (i + 1) & mask;
+        }
+        if (table[i].slot == NOT_FOUND) {
+            return false;
+        }
+        for (size_t j = (i + 1) & mask; table[j].slot != NOT_FOUND; j = (j + 1) & mask) {
+            // An entry may fill the hole only if its home bucket is not
+            // between the hole and itself
+            size_t home = bucketFor(table[j].id);
+            if (((j - home) & mask) >= ((j - i) & mask)) {
+                table[i] = table[j];
+                i = j;
+            }
+        }
+        table[i].slot = NOT_FOUND;
+        count--;
+        return true;
+    }
+};
+
+// ============================================================
+// FILE HANDLING CONCEPT - Binary data file
+// ============================================================
+
+// Fixed-size record per student; names and attendance bitmaps live in two
+// blocks after the records, so the whole file is read with one mmap
+struct StudentRecord {
+    int32_t id;
+    int32_t classes;            // Class days in the bitmap
+    uint32_t nameOffset;        // Into the name block
+    uint32_t nameLength;
+    uint64_t daysOffset;        // Into the day block, (classes + 7) / 8 bytes
+};
+static_assert(sizeof(StudentRecord) == 24, "student records must stay 24 bytes");
+
+// Versioned binary attendance data. Files are written to a temporary name,
+// synced and renamed over the old file, so a crash leaves either the old or
+// the new data intact - never a half-written file. Saves between full
+// writes go to an AttendanceLog; the file records the first log batch it
+// does not include yet.
+class AttendanceFile {
+private:
+    struct Header {
+        char magic[8];          // "ATTDATA\0"
+        uint32_t version;
+        uint32_t recordSize;
+        uint64_t studentCount;
+        int64_t totalClassDays;
+        uint64_t nameBytes;
+        uint64_t dayBytes;
+        uint64_t logSequence;   // First log batch not in this file (version 2)
+    };
+    static_assert(sizeof(Header) == 56, "header keeps records 8-byte aligned");
+
+    static const uint32_t VERSION = 2;      // 2: log sequence
+    static const size_t VERSION_1_HEADER = 48;
+
+    static bool writeAll(int fd, const void* data, size_t bytes) {
+        const char* p = static_cast<const char*>(data);
+        while (bytes > 0) {
+            ssize_t written = ::write(fd, p, bytes);
+            if (written < 0) {
+                if (errno == EINTR) continue;
+                return false;
+            }
+            p += written;
+            bytes -= static_cast<size_t>(written);
+        }
+        return true;
+    }
+
+public:
+    // Write every student to `path`, returns false on any I/O error
+    static bool write(const string& path, int totalClassDays, const vector<Student>& students,
+                      uint64_t logSequence = 0) {
+        vector<StudentRecord> records(students.size());
+        string names;
+        vector<uint8_t> days;
+        for (size_t i = 0; i < students.size(); i++) {
+            const Student& student = students[i];
+            const AttendanceBitmap& attendance = student.getAttendance();
+            StudentRecord& record = records[i];
+            record.id = student.getId();
+            record.classes = attendance.size();
+            record.nameOffset = static_cast<uint32_t>(names.size());
+            record.nameLength = static_cast<uint32_t>(student.getName().size());
+            record.daysOffset = days.size();
+            names += student.getName();
+            days.insert(days.end(), attendance.data(), attendance.data() + attendance.byteSize());
+        }
+
+        Header header;
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, "ATTDATA", 8);
+        header.version = VERSION;
+        header.recordSize = sizeof(StudentRecord);
+        header.studentCount = records.size();
+        header.totalClassDays = totalClassDays;
+        header.nameBytes = names.size();
+        header.dayBytes = days.size();
+        header.logSequence = logSequence;
+
+        string temporaryPath = path + ".tmp";
+        int fd = ::open(temporaryPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd < 0) {
+            return false;
+        }
+        bool ok = writeAll(fd, &header, sizeof(header)) &&
+                  writeAll(fd, records.data(), records.size() * sizeof(StudentRecord)) &&
+                  writeAll(fd, names.data(), names.size()) &&
+                  writeAll(fd, days.data(), days.size()) &&
+                  fdatasync(fd) == 0;
+        ok = ::close(fd) == 0 && ok;
+        if (!ok || rename(temporaryPath.c_str(), path.c_str()) != 0) {
+            unlink(temporaryPath.c_str());
+            return false;
+        }
+        return true;
+    }
+
+    // Map `path` and build `students` from it in one pass over the records
+    // Returns false (leaving the outputs untouched) if the file is missing,
+    // truncated or damaged
+    static bool read(const string& path, vector<Student>& students, int& totalClassDays,
+                     uint64_t* logSequence = nullptr) {
+        int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            return false;
+        }
+        struct stat info;
+        if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(Header)) {
+            ::close(fd);
+            return false;
+        }
+        size_t bytes = static_cast<size_t>(info.st_size);
+        void* mapping = mmap(nullptr, bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (mapping == MAP_FAILED) {
+            return false;
+        }
+        madvise(mapping, bytes, MADV_SEQUENTIAL);
+
+        const char* base = static_cast<const char*>(mapping);
+        Header header;
+        memset(&header, 0, sizeof(header));
+        memcpy(&header, base, VERSION_1_HEADER);
+        size_t headerSize = header.version == 1 ? VERSION_1_HEADER : sizeof(Header);
+        if (header.version == VERSION && bytes >= sizeof(Header)) {
+            memcpy(&header, base, sizeof(header));
+        }
+        bool valid = memcmp(header.magic, "ATTDATA", 8) == 0 &&
+                     (header.version == 1 || (header.version == VERSION && bytes >= sizeof(Header))) &&
+                     header.recordSize == sizeof(StudentRecord) &&
+                     header.totalClassDays >= 0 && header.totalClassDays <= INT32_MAX &&
+                     header.studentCount <= (bytes - headerSize) / sizeof(StudentRecord) &&
+                     header.nameBytes <= bytes && header.dayBytes <= bytes &&
+                     headerSize + header.studentCount * sizeof(StudentRecord) +
+                         header.nameBytes + header.dayBytes == bytes;
+
+        vector<Student> loaded;
+        if (valid) {
+            const char* recordBase = base + headerSize;
+            const char* names = recordBase + header.studentCount * sizeof(StudentRecord);
+            const uint8_t* days = reinterpret_cast<const uint8_t*>(names + header.nameBytes);
+            loaded.reserve(static_cast<size_t>(header.studentCount));
+            // LOOP: One pass - each record becomes a Student in place
+            for (size_t i = 0; i < header.studentCount && valid; i++) {
+                StudentRecord record;
+                memcpy(&record, recordBase + i * sizeof(StudentRecord), sizeof(record));
+                uint64_t dayLength = record.classes >= 0 ? (static_cast<uint64_t>(record.classes) + 7) / 8 : 0;
+                valid = record.classes >= 0 &&
+                        static_cast<uint64_t>(record.nameOffset) + record.nameLength <= header.nameBytes &&
+                        record.daysOffset <= header.dayBytes &&
+                        dayLength <= header.dayBytes - record.daysOffset;
+                if (valid) {
+                    loaded.emplace_back(record.id, string(names + record.nameOffset, record.nameLength));
+                    valid = loaded.back().setAttendance(days + record.daysOffset, record.classes);
+                }
+            }
+        }
+        munmap(mapping, bytes);
+        if (valid) {
+            students.swap(loaded);
+            totalClassDays = static_cast<int>(header.totalClassDays);
+            if (logSequence != nullptr) {
+                *logSequence = header.logSequence;
+            }
+        }
+        return valid;
+    }
+};
+
+// ============================================================
+// FILE HANDLING CONCEPT - Append-only change log
+// ============================================================
+
+// Changes saved since the last full data file. Each save appends one batch:
+// a DAY entry per class day marked (one bit per student), a STUDENT entry
+// per new or changed student (its whole record), then a COMMIT entry with
+// the batch's sequence number and checksum. The batch is written with one
+// write() and synced, so a save costs what changed, not every student.
+// On load, batches are replayed in order; a torn or damaged tail ends the
+// replay, and batches already in the data file (lower sequence) are skipped.
+// Entries are idempotent, so replaying a batch twice changes nothing.
+class AttendanceLog {
+private:
+    enum EntryType : uint32_t {
+        ENTRY_STUDENT = 1,      // StudentEntry, name, attendance bits
+        ENTRY_DAY = 2,          // DayEntry, one bit per student
+        ENTRY_COMMIT = 3        // CommitEntry, ends a batch
+    };
+
+    struct EntryHeader {
+        uint32_t type;
+        uint32_t length;        // Payload bytes after this header
+    };
+
+    struct StudentEntry {
+        uint32_t slot;          // Position in the students vector
+        int32_t id;
+        int32_t classes;
+        uint32_t nameLength;
+    };
+
+    struct DayEntry {
+        int32_t day;            // 0-based class day
+        uint32_t studentCount;  // Students the day was marked for
+    };
+
+    struct CommitEntry {
+        int32_t totalClassDays;
+        uint32_t entryCount;
+        uint64_t sequence;
+        uint64_t checksum;      // FNV-1a of the batch's entries
+    };
+
+    int fd;
+    uint64_t bytes;             // Committed bytes in the file
+    uint64_t nextSequence;
+    string batch;               // Entries of the save in progress
+    uint32_t batchEntries;
+
+    static uint64_t checksum(const char* data, size_t length) {
+        uint64_t hash = 1469598103934665603ULL;
+        for (size_t i = 0; i < length; i++) {
+            hash = (hash ^ static_cast<unsigned char>(data[i])) * 1099511628211ULL;
+        }
+        return hash;
+    }
+
+    void addEntry(uint32_t type, const void* fixed, size_t fixedBytes,
+                  const void* tail1, size_t tail1Bytes, const void* tail2, size_t tail2Bytes) {
+        EntryHeader header = {type, static_cast<uint32_t>(fixedBytes + tail1Bytes + tail2Bytes)};
+        batch.append(reinterpret_cast<const char*>(&header), sizeof(header));
+        batch.append(static_cast<const char*>(fixed), fixedBytes);
+        batch.append(static_cast<const char*>(tail1), tail1Bytes);
+        batch.append(static_cast<const char*>(tail2), tail2Bytes);
+        batchEntries++;
+    }
+
+    // Apply the entries of one committed batch; false if one is malformed
+    static bool apply(const char* data, size_t length, vector<Student>& students) {
+        size_t pos = 0;
+        while (pos < length) {
+            EntryHeader header;
+            memcpy(&header, data + pos, sizeof(header));
+            const char* payload = data + pos + sizeof(header);
+            if (header.length > length - pos - sizeof(header)) {
+                return false;
+            }
+            if (header.type == ENTRY_STUDENT && header.length >= sizeof(StudentEntry)) {
+                StudentEntry entry;
+                memcpy(&entry, payload, sizeof(entry));
+                size_t dayBytes = entry.classes >= 0 ? (static_cast<size_t>(entry.classes) + 7) / 8 : 0;
+                if (entry.classes < 0 || entry.slot > students.size() ||
+                    header.length != sizeof(entry) + entry.nameLength + dayBytes) {
+                    return false;
+                }
+                Student student(entry.id, string(payload + sizeof(entry), entry.nameLength));
+                if (!student.setAttendance(reinterpret_cast<const uint8_t*>(payload + sizeof(entry) +
+                                                                          entry.nameLength),
+                                           entry.classes)) {
+                    return false;
+                }
+                if (entry.slot == students.size()) {
+                    students.push_back(student);
+                } else {
+                    students[entry.slot] = student;
+                }
+            } else if (header.type == ENTRY_DAY && header.length >= sizeof(DayEntry)) {
+                DayEntry entry;
+                memcpy(&entry, payload, sizeof(entry));
+                if (header.length != sizeof(entry) + (static_cast<size_t>(entry.studentCount) + 7) / 8) {
+                    return false;
+                }
+                const uint8_t* bits = reinterpret_cast<const uint8_t*>(payload + sizeof(entry));
+                size_t count = min(static_cast<size_t>(entry.studentCount), students.size());
+                for (size_t slot = 0; slot < count; slot++) {
+                    // Only students whose record ends just before this day
+                    if (students[slot].getTotalClasses() == entry.day) {
+                        students[slot].markAttendance((bits[slot / 8] >> (slot % 8)) & 1);
+                    }
+                }
+            } else {
+                return false;
+            }
+            pos += sizeof(header) + header.length;
+        }
+        return true;
+    }
+
+public:
+    AttendanceLog() : fd(-1), bytes(0), nextSequence(0), batchEntries(0) {}
+    ~AttendanceLog() { close(); }
+
+    AttendanceLog(const AttendanceLog&) = delete;
+    AttendanceLog& operator=(const AttendanceLog&) = delete;
+
+    bool isOpen() const { return fd >= 0; }
+    uint64_t size() const { return bytes; }
+    uint64_t getNextSequence() const { return nextSequence; }
+
+    // Open `path` for appending after its first `validBytes` (a torn tail
+    // is cut off, so new batches never follow garbage). Batches written
+    // from now on are numbered from `sequence`.
+    bool open(const string& path, uint64_t validBytes, uint64_t sequence) {
+        close();
+        fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_CLOEXEC, 0644);
+        if (fd < 0 || ftruncate(fd, static_cast<off_t>(validBytes)) != 0 ||
+            lseek(fd, 0, SEEK_END) < 0) {
+            close();
+            return false;
+        }
+        bytes = validBytes;
+        nextSequence = sequence;
+        return true;
+    }
+
+    void close() {
+        if (fd >= 0) {
+            ::close(fd);
+            fd = -1;
+        }
+        batch.clear();
+        batchEntries = 0;
+    }
+
+    // Record the whole current state of the student at `slot`
+    void addStudent(uint32_t slot, const Student& student) {
+        const AttendanceBitmap& attendance = student.getAttendance();
+        StudentEntry entry = {slot, student.getId(), attendance.size(),
+                              static_cast<uint32_t>(student.getName().size())};
+        addEntry(ENTRY_STUDENT, &entry, sizeof(entry), student.getName().data(), entry.nameLength,
+                 attendance.data(), attendance.byteSize());
+    }
+
+    // Record class day `day` for every student
+    void addDay(int day, const vector<Student>& students) {
+        vector<uint8_t> bits((students.size() + 7) / 8, 0);
+        for (size_t slot = 0; slot < students.size(); slot++) {
+            if (students[slot].wasPresent(day)) {
+                bits[slot / 8] |= static_cast<uint8_t>(1u << (slot % 8));
+            }
+        }
+        DayEntry entry = {day, static_cast<uint32_t>(students.size())};
+        addEntry(ENTRY_DAY, &entry, sizeof(entry), bits.data(), bits.size(), nullptr, 0);
+    }
+
+    // Append the batch with one write() and sync it. On an I/O error the
+    // batch is dropped (callers still know what changed) and false returned.
+    bool commit(int totalClassDays) {
+        CommitEntry entry = {totalClassDays, batchEntries, nextSequence,
+                             checksum(batch.data(), batch.size())};
+        addEntry(ENTRY_COMMIT, &entry, sizeof(entry), nullptr, 0, nullptr, 0);
+        const char* p = batch.data();
+        size_t remaining = batch.size();
+        bool ok = fd >= 0;
+        while (ok && remaining > 0) {
+            ssize_t written = ::write(fd, p, remaining);
+            if (written < 0 && errno == EINTR) continue;
+            ok = written > 0;
+            if (ok) {
+                p += written;
+                remaining -= static_cast<size_t>(written);
+            }
+        }
+        ok = ok && fdatasync(fd) == 0;
+        if (!ok) {
+            if (fd >= 0 && ftruncate(fd, static_cast<off_t>(bytes)) != 0) {
+                close();  // Unknown tail - stop appending until reopened
+            }
+            discardBatch();
+            return false;
+        }
+        bytes += batch.size();
+        nextSequence++;
+        batch.clear();
+        batchEntries = 0;
+        return true;
+    }
+
+    // Drop the entries added since the last commit
+    void discardBatch() {
+        batch.clear();
+        batchEntries = 0;
+    }
+
+    // Replay the committed batches of `path` numbered `nextSequence` or
+    // later onto `students`; `nextSequence` moves past every batch seen.
+    // Pass nullptr to only find the sequence numbers. Returns the bytes of
+    // intact batches (0 if the file is missing).
+    static uint64_t replay(const string& path, vector<Student>* students, int& totalClassDays,
+                           uint64_t& nextSequence) {
+        int file = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (file < 0) {
+            return 0;
+        }
+        struct stat info;
+        if (fstat(file, &info) != 0 || info.st_size == 0) {
+            ::close(file);
+            return 0;
+        }
+        size_t length = static_cast<size_t>(info.st_size);
+        void* mapping = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, file, 0);
+        ::close(file);
+        if (mapping == MAP_FAILED) {
+            return 0;
+        }
+        const char* data = static_cast<const char*>(mapping);
+        size_t pos = 0, batchStart = 0, committed = 0;
+        // LOOP: Walk entries, applying each batch once its commit checks out
+        while (length - pos >= sizeof(EntryHeader)) {
+            EntryHeader header;
+            memcpy(&header, data + pos, sizeof(header));
+            if (header.length > length - pos - sizeof(header)) {
+                break;  // Torn tail
+            }
+            if (header.type == ENTRY_COMMIT) {
+                CommitEntry entry;
+                if (header.length != sizeof(entry)) {
+                    break;
+                }
+                memcpy(&entry, data + pos + sizeof(header), sizeof(entry));
+                if (entry.checksum != checksum(data + batchStart, pos - batchStart) ||
+                    entry.totalClassDays < 0) {
+                    break;  // Damaged batch
+                }
+                if (entry.sequence >= nextSequence) {
+                    if (students != nullptr && !apply(data + batchStart, pos - batchStart, *students)) {
+                        break;
+                    }
+                    totalClassDays = entry.totalClassDays;
+                    nextSequence = entry.sequence + 1;
+                }
+                pos += sizeof(header) + header.length;
+                batchStart = committed = pos;
+            } else {
+                pos += sizeof(header) + header.length;
+            }
+        }
+        munmap(mapping, length);
+        return committed;
+    }
+};
+
+// ============================================================
+// FILE HANDLING CONCEPT - Scanner event streams
+// ============================================================
+
+// One turnstile or roster scan. Also the record layout of binary streams.
+struct ScanEvent {
+    int32_t studentId;
+    int32_t classDay;       // 1-based, as shown in the menus
+    uint8_t present;        // 1 present, 0 absent
+    uint8_t reserved[3];
+};
+static_assert(sizeof(ScanEvent) == 12, "scan events are stored as-is in binary streams");
+
+// Reads scan events in batches from either format, detected by the first
+// bytes of the file:
+//   binary - "ATTSCAN\0", uint32 version, uint32 record size, then records
+//   CSV    - one "studentId,classDay,present" per line; present is 1/0 or
+//            P/A, and a header line starting with a letter is skipped
+//            Lines end with \n, \r\n or a lone \r; a line longer than the
+//            1 MiB buffer is counted as malformed and skipped
+// Input is read in large blocks and parsed by hand, without iostreams.
+class ScanEventReader {
+private:
+    struct Header {
+        char magic[8];      // "ATTSCAN\0"
+        uint32_t version;
+        uint32_t recordSize;
+    };
+
+    static const uint32_t VERSION = 1;
+    static const size_t BUFFER_BYTES = 1 << 20;
+
+    int fd;
+    bool binary;
+    bool endOfFile;
+    bool firstLine;
+    bool skippingLine;      // Inside an overlong line, dropping bytes to its end
+    vector<char> buffer;
+    size_t begin;           // Unparsed bytes are buffer[begin, end)
+    size_t end;
+    uint64_t malformed;     // Lines or trailing bytes that were not events
+
+    // Keep the unparsed tail, then fill the rest of the buffer
+    void refill() {
+        memmove(buffer.data(), buffer.data() + begin, end - begin);
+        end -= begin;
+        begin = 0;
+        while (!endOfFile && end < buffer.size()) {
+            ssize_t got = ::read(fd, buffer.data() + end, buffer.size() - end);
+            if (got < 0 && errno == EINTR) continue;
+            if (got <= 0) {
+                endOfFile = true;
+                break;
+            }
+            end += static_cast<size_t>(got);
+        }
+    }
+
+    static bool parseInt(const char*& p, const char* limit, int32_t& value) {
+        while (p < limit && (*p == ' ' || *p == '\t')) p++;
+        bool negative = p < limit && *p == '-';
+        if (negative || (p < limit && *p == '+')) p++;
+        const char* digits = p;
+        int64_t result = 0;
+        while (p < limit && *p >= '0' && *p <= '9' && result <= INT32_MAX) {
+            result = result * 10 + (*p++ - '0');
+        }
+        if (p == digits || result > INT32_MAX) {
+            return false;
+        }
+        value = static_cast<int32_t>(negative ? -result : result);
+        while (p < limit && (*p == ' ' || *p == '\t')) p++;
+        return true;
+    }
+
+    // First '\n' or '\r' in [p, limit), or nullptr
+    // (one pass; lines are short, so this beats two memchr calls)
+    static const char* findLineEnd(const char* p, const char* limit) {
+        for (; p < limit; p++) {
+            if (*p == '\n' || *p == '\r') {
+                return p;
+            }
+        }
+        return nullptr;
+    }
+
+    // Parse one CSV line [p, limit) without its newline
+    bool parseLine(const char* p, const char* limit, ScanEvent& event) {
+        int32_t id, day;
+        if (!parseInt(p, limit, id) || p == limit || *p++ != ',' ||
+            !parseInt(p, limit, day) || p == limit || *p++ != ',') {
+            return false;
+        }
+        while (p < limit && (*p == ' ' || *p == '\t')) p++;
+        if (p == limit) {
+            return false;
+        }
+        char flag = static_cast<char>(toupper(*p++));
+        while (p < limit && (*p == ' ' || *p == '\t' || *p == '\r')) p++;
+        if (p != limit || (flag != '1' && flag != '0' && flag != 'P' && flag != 'A')) {
+            return false;
+        }
+        memset(&event, 0, sizeof(event));
+        event.studentId = id;
+        event.classDay = day;
+        event.present = flag == '1' || flag == 'P';
+        return true;
+    }
+
+public:
+    explicit ScanEventReader(const string& path)
+        : binary(false), endOfFile(false), firstLine(true), skippingLine(false), buffer(BUFFER_BYTES),
+          begin(0), end(0), malformed(0) {
+        fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            return;
+        }
+        refill();
+        Header header;
+        if (end >= sizeof(header) && memcmp(buffer.data(), "ATTSCAN", 8) == 0) {
+            memcpy(&header, buffer.data(), sizeof(header));
+            if (header.version != VERSION || header.recordSize != sizeof(ScanEvent)) {
+                ::close(fd);
+                fd = -1;
+                return;
+            }
+            binary = true;
+            begin = sizeof(header);
+        }
+    }
+
+    ~ScanEventReader() {
+        if (fd >= 0) {
+            ::close(fd);
+        }
+    }
+
+    ScanEventReader(const ScanEventReader&) = delete;
+    ScanEventReader& operator=(const ScanEventReader&) = delete;
+
+    bool isOpen() const { return fd >= 0; }
+    bool isBinary() const { return binary; }
+    uint64_t getMalformed() const { return malformed; }
+
+    // Read up to `limit` events into `events` (replacing its contents)
+    // Returns false once the input is exhausted and nothing was read
+    bool next(vector<ScanEvent>& events, size_t limit) {
+        events.clear();
+        while (fd >= 0 && events.size() < limit) {
+            if (binary) {
+                size_t available = (end - begin) / sizeof(ScanEvent);
+                size_t take = min(available, limit - events.size());
+                size_t first = events.size();
+                events.resize(first + take);
+                memcpy(&events[first], buffer.data() + begin, take * sizeof(ScanEvent));
+                begin += take * sizeof(ScanEvent);
+            } else {
+                const char* data = buffer.data();
+                while (events.size() < limit && begin < end) {
+                    const char* line = data + begin;
+                    const char* terminator = findLineEnd(line, data + end);
+                    if (terminator == nullptr && !endOfFile) {
+                        if (begin == 0 && end == buffer.size()) {
+                            // No line end in a full buffer: drop the line
+                            malformed += !skippingLine;
+                            skippingLine = true;
+                            firstLine = false;
+                            begin = end;
+                        }
+                        break;  // Incomplete line - refill first
+                    }
+                    const char* lineEnd = terminator != nullptr ? terminator : data + end;
+                    begin = static_cast<size_t>(lineEnd - data) + (terminator != nullptr);
+                    if (skippingLine) {
+                        skippingLine = false;  // Rest of an overlong line
+                        continue;
+                    }
+                    ScanEvent event;
+                    if (parseLine(line, lineEnd, event)) {
+                        events.push_back(event);
+                    } else if (!(firstLine && line < lineEnd && isalpha(static_cast<unsigned char>(*line))) &&
+                               line != lineEnd) {
+                        malformed++;
+                    }
+                    firstLine = false;
+                }
+            }
+            if (events.size() == limit) {
+                break;
+            }
+            if (endOfFile) {
+                if (binary && begin < end) {
+                    malformed++;  // Truncated last record
+                }
+                begin = end;
+                break;
+            }
+            refill();
+        }
+        return !events.empty();
+    }
+
+    // Write `events` as a binary stream; false on any I/O error
+    static bool writeBinary(const string& path, const vector<ScanEvent>& events) {
+        FILE* file = fopen(path.c_str(), "wb");
+        if (file == nullptr) {
+            return false;
+        }
+        Header header;
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, "ATTSCAN", 8);
+        header.version = VERSION;
+        header.recordSize = sizeof(ScanEvent);
+        bool ok = fwrite(&header, sizeof(header), 1, file) == 1 &&
+                  fwrite(events.data(), sizeof(ScanEvent), events.size(), file) == events.size();
+        return fclose(file) == 0 && ok;
+    }
+};
+
+// What one scan import did
+struct ScanImportSummary {
+    uint64_t events = 0;          // Events read
+    uint64_t applied = 0;         // Events recorded
+    uint64_t unknownStudents = 0; // IDs that are not registered
+    uint64_t invalid = 0;         // Bad class days or unparsable input
+    int newDays = 0;              // Class days opened by the import
+    double seconds = 0;
+};
+
 // ============================================================
 // CLASSES CONCEPT - AttendanceSystem Class Definition
 // ============================================================
@@ -88,84 +1036,329 @@ public:
 // Attendance Management System class
 // Demonstrates: COMPOSITION, FILE HANDLING, VECTOR OPERATIONS
 class AttendanceSystem {
+public:
+    static constexpr const char* DATA_PREFIX = "attendance_data";    // Default data file names
+    static constexpr const char* TEXT_FILE = "attendance_data.txt";  // Old format, imported once
+    static const uint64_t COMPACT_MIN_BYTES = 1 << 20;              // Smallest log worth compacting
+
 private:
     // VECTOR (DYNAMIC ARRAY) - ARRAYS CONCEPT
     // Demonstrates: VECTOR as a dynamic array to store Student objects
     vector<Student> students;  // Dynamic array of Student objects
+    StudentIndex index;        // Student ID -> position in students
     int totalClassDays;        // Total number of class days
+    bool persistent;           // Load/save the data file automatically
+
+    // FILE HANDLING: <prefix>.bin holds every student, <prefix>.log the
+    // saves since then and <prefix>.log.old a log being compacted into .bin
+    string dataPath;
+    string logPath;
+    string compactingPath;
+
+    // INCREMENTAL SAVING: Only what changed since the last save is written
+    AttendanceLog changeLog;
+    vector<uint8_t> dirty;         // Per student: changed since the last save
+    vector<uint32_t> dirtySlots;   // The changed students
+    vector<int> markedDays;        // Class days marked since the last save
+    bool fullSaveNeeded;           // No usable data file: the next save writes all
+    thread compactor;              // Folds the old log into the data file
+    atomic<bool> compactionFailed;
+
+    void markDirty(size_t slot) {
+        if (dirty.size() < students.size()) {
+            dirty.resize(students.size(), 0);
+        }
+        if (!dirty[slot]) {
+            dirty[slot] = 1;
+            dirtySlots.push_back(static_cast<uint32_t>(slot));
+        }
+    }
+
+    void clearChanges() {
+        for (uint32_t slot : dirtySlots) {
+            dirty[slot] = 0;
+        }
+        dirtySlots.clear();
+        markedDays.clear();
+    }
+
+    // Index every student after the vector was replaced (first ID wins)
+    void rebuildIndex() {
+        index.clear();
+        index.reserve(students.size());
+        for (size_t slot = 0; slot < students.size(); slot++) {
+            index.insert(students[slot].getId(), static_cast<uint32_t>(slot));
+        }
+    }
+
+    // Write every student to the data file and start an empty log
+    bool saveAll() {
+        waitForCompaction();
+        // Number batches past any still on disk, so none is replayed later
+        int ignoredDays = 0;
+        uint64_t sequence = changeLog.getNextSequence();
+        AttendanceLog::replay(compactingPath, nullptr, ignoredDays, sequence);
+        AttendanceLog::replay(logPath, nullptr, ignoredDays, sequence);
+        if (!AttendanceFile::write(dataPath, totalClassDays, students, sequence)) {
+            return false;
+        }
+        unlink(compactingPath.c_str());
+        fullSaveNeeded = false;
+        clearChanges();
+        return changeLog.open(logPath, 0, sequence);
+    }
+
+    // Append the changes since the last save to the log as one batch
+    // Days go first: the student records after them are complete anyway
+    bool saveChanges() {
+        if (dirtySlots.empty() && markedDays.empty()) {
+            return true;
+        }
+        sort(dirtySlots.begin(), dirtySlots.end());  // New students in slot order
+        for (int day : markedDays) {
+            changeLog.addDay(day, students);
+        }
+        for (uint32_t slot : dirtySlots) {
+            changeLog.addStudent(slot, students[slot]);
+        }
+        if (!changeLog.commit(totalClassDays)) {
+            return false;
+        }
+        clearChanges();
+        if (changeLog.size() > max<uint64_t>(COMPACT_MIN_BYTES, students.size() * sizeof(StudentRecord))) {
+            startCompaction();
+        }
+        return true;
+    }
+
+    // Move the log aside and fold it into the data file on another thread;
+    // saves keep appending to a fresh log meanwhile
+    void startCompaction() {
+        waitForCompaction();
+        // A failed compaction leaves its log behind; retry that one first
+        if (access(compactingPath.c_str(), F_OK) != 0) {
+            uint64_t logBytes = changeLog.size();
+            uint64_t sequence = changeLog.getNextSequence();
+            changeLog.close();
+            if (rename(logPath.c_str(), compactingPath.c_str()) != 0) {
+                changeLog.open(logPath, logBytes, sequence);
+                return;
+            }
+            changeLog.open(logPath, 0, sequence);  // If this fails, the next save writes all
+        }
+        string data = dataPath, compacting = compactingPath;
+        compactor = thread([this, data, compacting]() {
+            vector<Student> merged;
+            int days = 0;
+            uint64_t sequence = 0;
+            bool ok = AttendanceFile::read(data, merged, days, &sequence);
+            if (ok) {
+                AttendanceLog::replay(compacting, &merged, days, sequence);
+                ok = AttendanceFile::write(data, days, merged, sequence) &&
+                     unlink(compacting.c_str()) == 0;
+            }
+            if (!ok) {
+                compactionFailed = true;
+            }
+        });
+    }
 
 public:
     // CONSTRUCTOR - Initializes system and loads data from file
     // Demonstrates: CONSTRUCTOR, FILE HANDLING INITIALIZATION
-    AttendanceSystem() : totalClassDays(0) {
-        loadFromFile();  // Load existing data when system starts
+    // Pass false for a scratch system that never touches the data file
+    AttendanceSystem(bool usePersistence = true, const string& filePrefix = DATA_PREFIX)
+        : totalClassDays(0), persistent(usePersistence), dataPath(filePrefix + ".bin"),
+          logPath(filePrefix + ".log"), compactingPath(filePrefix + ".log.old"),
+          fullSaveNeeded(true), compactionFailed(false) {
+        if (persistent) {
+            loadFromFile();  // Load existing data when system starts
+        }
     }
 
     // DESTRUCTOR - Saves data to file when system closes
     // Demonstrates: DESTRUCTOR, AUTOMATIC CLEANUP
     ~AttendanceSystem() {
-        saveToFile();  // Save data when system ends
+        if (persistent) {
+            saveToFile();  // Save data when system ends
+        }
+        waitForCompaction();
+    }
+
+    // ARRAY OPERATION: Append a student record without prompting
+    // Returns false (adding nothing) if the ID is already registered
+    bool addStudent(const Student& student) {
+        if (!index.insert(student.getId(), static_cast<uint32_t>(students.size()))) {
+            return false;
+        }
+        students.push_back(student);
+        markDirty(students.size() - 1);
+        return true;
+    }
+
+    // HASH LOOKUP: The student with this ID, or nullptr
+    const Student* findStudent(int id) const {
+        uint32_t slot = index.find(id);
+        return slot != StudentIndex::NOT_FOUND ? &students[slot] : nullptr;
+    }
+
+    // Pre-size storage before registering many students
+    void reserveStudents(size_t count) {
+        students.reserve(count);
+        index.reserve(count);
+    }
+
+    const vector<Student>& getStudents() const { return students; }
+    int getTotalClassDays() const { return totalClassDays; }
+
+    // Block until a background compaction has finished with the data file
+    void waitForCompaction() {
+        if (compactor.joinable()) {
+            compactor.join();
+        }
+        if (compactionFailed.exchange(false)) {
+            cout << "Warning: Log compaction failed; the log is kept and retried later.\n";
+        }
+    }
+
+    // ============================================================
+    // FILE HANDLING CONCEPT - Load data from file
+    // ============================================================
+    // Demonstrates: Binary file handling, with the old text file as fallback
+    // The data file plus the saves logged after it replace whatever is in
+    // memory. Without one, an existing text file is imported instead.
+    void loadFromFile() {
+        waitForCompaction();
+        uint64_t sequence = 0;
+        if (AttendanceFile::read(dataPath, students, totalClassDays, &sequence)) {
+            AttendanceLog::replay(compactingPath, &students, totalClassDays, sequence);
+            uint64_t logBytes = AttendanceLog::replay(logPath, &students, totalClassDays, sequence);
+            fullSaveNeeded = !changeLog.open(logPath, logBytes, sequence);
+            clearChanges();
+            dirty.assign(students.size(), 0);
+            rebuildIndex();
+            cout << "Data loaded successfully!\n";
+        } else if (access(dataPath.c_str(), F_OK) == 0) {
+            // Never overwrite a damaged file with an empty system on exit
+            persistent = false;
+            cout << "Error: '" << dataPath << "' is damaged and was not loaded.\n";
+            cout << "Changes will only be saved with 'Save Data'.\n";
+        } else if (importText(TEXT_FILE)) {
+            cout << "Data imported from '" << TEXT_FILE << "'.\n";
+        } else {
+            // File doesn't exist - start fresh
+            cout << "No previous data found. Starting fresh.\n";
+        }
+    }
+
+    // Save without printing: the changes since the last save are appended
+    // to the log, or everything is written when there is no data file yet
+    bool save() {
+        return fullSaveNeeded || !changeLog.isOpen() ? saveAll() : saveChanges();
+    }
+
+    // ============================================================
+    // FILE HANDLING CONCEPT - Save data to file
+    // ============================================================
+    // Demonstrates: Crash-safe binary writing (append-only log + rename)
+    void saveToFile() {
+        if (save()) {
+            cout << "Data saved successfully!\n";
+        } else {
+            cout << "Error: Unable to save data to file.\n";
+        }
     }
 
     // ============================================================
-    // FILE HANDLING CONCEPT - Load data from file
+    // FILE HANDLING CONCEPT - Import data from a text file
     // ============================================================
     // Demonstrates: ifstream (input file stream), File reading
-    void loadFromFile() {
-        ifstream inFile("attendance_data.txt");  // Open file for reading
+    // Replaces the students in memory; returns false if the file is missing
+    bool importText(const string& path) {
+        ifstream inFile(path);  // Open file for reading
+        
+        if (!inFile.is_open()) {  // Check if file opened successfully
+            return false;
+        }
+        students.clear();
+        index.clear();
+        clearChanges();
+        dirty.clear();
+        fullSaveNeeded = true;  // Replaces everything saved so far
         
-        if (inFile.is_open()) {  // Check if file opened successfully
-            int numStudents;
-            // Read number of students and total class days from file
-            inFile >> numStudents >> totalClassDays;
+        // Files starting with "v2" hold per-day bitmaps; older ones
+        // start with the student count and hold only counters
+        string first;
+        int numStudents = 0;
+        inFile >> first;
+        bool hasDays = first == "v2";
+        if (hasDays) {
+            inFile >> numStudents;
+        } else {
+            numStudents = atoi(first.c_str());
+        }
+        // Read total class days from file
+        inFile >> totalClassDays;
+        
+        // Loop to read each student's data
+        for (int i = 0; i < numStudents; i++) {
+            int id, totalClasses, attendedClasses;
+            string name;
             
-            // Loop to read each student's data
-            for (int i = 0; i < numStudents; i++) {
-                int id, totalClasses, attendedClasses;
-                string name;
-                
-                // Read student data from file
-                inFile >> id;
-                inFile.ignore();  // Ignore newline character
-                getline(inFile, name);  // Read full name (may contain spaces)
-                inFile >> totalClasses >> attendedClasses;
-                
-                // Create Student object and add to vector (ARRAY OPERATION)
-                students.push_back(Student(id, name, totalClasses, attendedClasses));
-            }
+            // Read student data from file
+            inFile >> id;
+            inFile.ignore();  // Ignore newline character
+            getline(inFile, name);  // Read full name (may contain spaces)
+            inFile >> totalClasses >> attendedClasses;
             
-            inFile.close();  // Close the file
-            cout << "Data loaded successfully!\n";
-        } else {
-            // File doesn't exist - start fresh
-            cout << "No previous data found. Starting fresh.\n";
+            // Create Student object and add to vector (ARRAY OPERATION)
+            Student student(id, name, totalClasses, attendedClasses);
+            if (hasDays) {
+                string days;
+                AttendanceBitmap attendance;
+                inFile >> days;
+                if (attendance.fromHex(days, totalClasses) &&
+                    attendance.countPresent() == attendedClasses) {
+                    student.setAttendance(attendance);
+                } else {
+                    cout << "Warning: Daily record of student " << id
+                         << " is damaged; keeping totals only.\n";
+                }
+            }
+            if (!addStudent(student)) {
+                cout << "Warning: Duplicate student ID " << id << " skipped.\n";
+            }
         }
+        
+        inFile.close();  // Close the file
+        return true;
     }
 
     // ============================================================
-    // FILE HANDLING CONCEPT - Save data to file
+    // FILE HANDLING CONCEPT - Export data to a text file
     // ============================================================
     // Demonstrates: ofstream (output file stream), File writing
-    void saveToFile() {
-        ofstream outFile("attendance_data.txt");  // Open file for writing
+    bool exportText(const string& path) {
+        ofstream outFile(path);  // Open file for writing
         
-        if (outFile.is_open()) {
-            // Write number of students and total class days
-            outFile << students.size() << " " << totalClassDays << endl;
-            
-            // Loop through all students and write their data to file
-            for (const auto& student : students) {
-                outFile << student.getId() << endl
-                       << student.getName() << endl
-                       << student.getTotalClasses() << " " 
-                       << student.getAttendedClasses() << endl;
-            }
-            
-            outFile.close();  // Close the file
-            cout << "Data saved successfully!\n";
-        } else {
-            cout << "Error: Unable to save data to file.\n";
+        if (!outFile.is_open()) {
+            return false;
+        }
+        // Write format version, number of students and total class days
+        outFile << "v2 " << students.size() << " " << totalClassDays << "\n";
+        
+        // Loop through all students and write their data to file
+        // The counts are followed by the per-day bitmap in hex
+        for (const auto& student : students) {
+            outFile << student.getId() << "\n"
+                   << student.getName() << "\n"
+                   << student.getTotalClasses() << " " 
+                   << student.getAttendedClasses() << "\n"
+                   << student.getAttendance().toHex() << "\n";
         }
+        
+        outFile.close();  // Close the file
+        return !outFile.fail();
     }
 
     // ============================================================
@@ -180,13 +1373,10 @@ public:
         cout << "Enter Student ID: ";
         cin >> id;
         
-        // LINEAR SEARCH in array - Check if ID already exists
-        // Demonstrates: ARRAY TRAVERSAL
-        for (const auto& student : students) {
-            if (student.getId() == id) {
-                cout << "Error: Student ID already exists!\n";
-                return;
-            }
+        // HASH LOOKUP - Check if ID already exists
+        if (findStudent(id) != nullptr) {
+            cout << "Error: Student ID already exists!\n";
+            return;
         }
         
         cin.ignore();  // Clear input buffer
@@ -197,7 +1387,7 @@ public:
         Student newStudent(id, name, totalClassDays, 0);
         
         // ARRAY OPERATION: Add new student to end of vector
-        students.push_back(newStudent);
+        addStudent(newStudent);
         
         cout << "Student registered successfully!\n";
     }
@@ -217,27 +1407,153 @@ public:
         
         // Loop through all students in array
         // Demonstrates: ARRAY TRAVERSAL with auto reference
-        for (auto& student : students) {
+        vector<bool> present;
+        present.reserve(students.size());
+        for (const auto& student : students) {
             char attendance;
             cout << student.getName() << " (ID: " << student.getId() << "): ";
             cin >> attendance;
-            
-            // Call Student's member function to mark attendance
-            if (toupper(attendance) == 'P') {
-                student.markAttendance(true);
-            } else {
-                student.markAttendance(false);
-            }
+            present.push_back(toupper(attendance) == 'P');
         }
         
-        totalClassDays++;
+        recordClassDay(present);
         cout << "\nAttendance marked for all students!\n";
     }
 
+    // ARRAY TRAVERSAL: Record the next class day without prompting
+    // present[i] is the attendance of the i-th student (absent if missing)
+    void recordClassDay(const vector<bool>& present) {
+        for (size_t slot = 0; slot < students.size(); slot++) {
+            // A record out of step with the class days is saved whole
+            if (students[slot].getTotalClasses() != totalClassDays) {
+                markDirty(slot);
+            }
+            // Call Student's member function to mark attendance
+            students[slot].markAttendance(slot < present.size() && present[slot]);
+        }
+        markedDays.push_back(totalClassDays);
+        totalClassDays++;
+    }
+
+    // Same as `count` calls to recordClassDay with nobody present, but
+    // visits each student once
+    void openClassDays(int count) {
+        for (size_t slot = 0; slot < students.size(); slot++) {
+            if (students[slot].getTotalClasses() != totalClassDays) markDirty(slot);
+            students[slot].markAbsentDays(count);
+        }
+        for (int i = 0; i < count; i++) {
+            markedDays.push_back(totalClassDays++);
+        }
+    }
+
+    // ============================================================
+    // BULK INGEST - Scanner and roster events
+    // ============================================================
+    // Events may open new class days (up to MAX_DAYS_AHEAD past the last
+    // one) or correct earlier days; when several events name the same
+    // student and day, the last one wins.
+    static const int MAX_DAYS_AHEAD = 366;
+    static const size_t SCAN_BATCH = 1 << 20;
+
+    // Apply one batch of events. `sorted` groups the batch by student first,
+    // keeping arrival order within each student (the sorted merge); false
+    // applies events in arrival order.
+    void applyScanBatch(const vector<ScanEvent>& events, vector<uint64_t>& keys,
+                        vector<uint64_t>& sortedKeys, vector<uint32_t>& slotStart,
+                        ScanImportSummary& summary, bool sorted = true) {
+        // HASH LOOKUP: Resolve every ID to its slot once
+        keys.clear();
+        int lastDay = totalClassDays;
+        for (const ScanEvent& event : events) {
+            if (event.classDay < 1 || event.classDay > totalClassDays + MAX_DAYS_AHEAD) {
+                summary.invalid++;
+                continue;
+            }
+            uint32_t slot = index.find(event.studentId);
+            if (slot == StudentIndex::NOT_FOUND) {
+                summary.unknownStudents++;
+                continue;
+            }
+            lastDay = max(lastDay, event.classDay);
+            // Key: slot, 0-based day, present - ordered by slot, then day
+            keys.push_back(static_cast<uint64_t>(slot) << 32 |
+                           static_cast<uint64_t>(event.classDay - 1) << 1 | (event.present & 1));
+        }
+        // New days start with everyone absent; scans then mark who came
+        if (lastDay > totalClassDays) {
+            summary.newDays += lastDay - totalClassDays;
+            openClassDays(lastDay - totalClassDays);
+        }
+        // SORTED MERGE: Group the batch by student with a counting sort, so
+        // each bitmap is visited once; stable, so the last event still wins
+        if (sorted && !keys.empty()) {
+            slotStart.assign(students.size() + 1, 0);
+            for (uint64_t key : keys) {
+                slotStart[(key >> 32) + 1]++;
+            }
+            for (size_t slot = 1; slot < slotStart.size(); slot++) {
+                slotStart[slot] += slotStart[slot - 1];
+            }
+            sortedKeys.resize(keys.size());
+            for (uint64_t key : keys) {
+                sortedKeys[slotStart[key >> 32]++] = key;
+            }
+            keys.swap(sortedKeys);
+        }
+        // Days from here on are saved as DAY entries; earlier ones need the record
+        int firstUnsavedDay = markedDays.empty() ? totalClassDays : markedDays.front();
+        for (uint64_t key : keys) {
+            uint32_t slot = static_cast<uint32_t>(key >> 32);
+            int day = static_cast<int>((key >> 1) & 0x7FFFFFFF);
+            bool present = key & 1;
+            Student& student = students[slot];
+            if (day >= student.getTotalClasses()) {
+                summary.invalid++;  // Record out of step with the class days
+                continue;
+            }
+            if (student.wasPresent(day) != present) {
+                student.setPresent(day, present);
+                if (day < firstUnsavedDay) {
+                    markDirty(slot);
+                }
+            }
+            summary.applied++;
+        }
+    }
+
+    // Read every event from `reader` and apply them batch by batch
+    ScanImportSummary importScans(ScanEventReader& reader, bool sorted = true) {
+        ScanImportSummary summary;
+        auto start = chrono::steady_clock::now();
+        vector<ScanEvent> events;
+        vector<uint64_t> keys, sortedKeys;
+        vector<uint32_t> slotStart;
+        while (reader.next(events, SCAN_BATCH)) {
+            summary.events += events.size();
+            applyScanBatch(events, keys, sortedKeys, slotStart, summary, sorted);
+        }
+        summary.invalid += reader.getMalformed();
+        summary.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        return summary;
+    }
+
+    // Print what an import did
+    static void displayScanSummary(const ScanImportSummary& summary) {
+        cout << "Events read:       " << summary.events << "\n";
+        cout << "Applied:           " << summary.applied << "\n";
+        cout << "Unknown students:  " << summary.unknownStudents << "\n";
+        cout << "Invalid:           " << summary.invalid << "\n";
+        cout << "New class days:    " << summary.newDays << "\n";
+        cout << "Time:              " << fixed << setprecision(3) << summary.seconds << " s ("
+             << setprecision(0) << (summary.seconds > 0 ? summary.events / summary.seconds : 0.0)
+             << " events/sec)\n";
+    }
+
     // ============================================================
-    // ARRAY SEARCHING - Calculate attendance percentage
+    // HASH LOOKUP - Calculate attendance percentage
     // ============================================================
-    // Demonstrates: LINEAR SEARCH in array
+    // Demonstrates: Searching by key through an index
     void calculateAttendancePercentage() {
         if (students.empty()) {
             cout << "No students registered yet!\n";
@@ -249,35 +1565,84 @@ public:
         cout << "Enter Student ID: ";
         cin >> id;
         
-        bool found = false;
-        // LINEAR SEARCH: Iterate through array to find student
-        for (const auto& student : students) {
-            if (student.getId() == id) {
-                // Found student - display attendance details
-                cout << "\nStudent: " << student.getName() 
-                     << " (ID: " << student.getId() << ")\n";
-                cout << "Total Classes: " << student.getTotalClasses() << "\n";
-                cout << "Classes Attended: " << student.getAttendedClasses() << "\n";
-                cout << "Attendance Percentage: " << fixed << setprecision(2) 
-                     << student.getAttendancePercentage() << "%\n";
-                
-                // Show attendance status
-                if (student.getAttendancePercentage() >= 75) {
-                    cout << "Status: Good Attendance ✓\n";
-                } else if (student.getAttendancePercentage() >= 50) {
-                    cout << "Status: Warning! Low Attendance ⚠\n";
-                } else {
-                    cout << "Status: Critical! Very Low Attendance ✗\n";
-                }
-                
-                found = true;
-                break;  // Exit loop once found
-            }
+        // HASH LOOKUP: Find the student without scanning the array
+        const Student* found = findStudent(id);
+        if (found == nullptr) {
+            cout << "Error: Student ID not found!\n";
+            return;
         }
+        const Student& student = *found;
         
-        if (!found) {
-            cout << "Error: Student ID not found!\n";
+        // Found student - display attendance details
+        cout << "\nStudent: " << student.getName() 
+             << " (ID: " << student.getId() << ")\n";
+        cout << "Total Classes: " << student.getTotalClasses() << "\n";
+        cout << "Classes Attended: " << student.getAttendedClasses() << "\n";
+        cout << "Attendance Percentage: " << fixed << setprecision(2) 
+             << student.getAttendancePercentage() << "%\n";
+        
+        // Show attendance status
+        if (student.getAttendancePercentage() >= 75) {
+            cout << "Status: Good Attendance ✓\n";
+        } else if (student.getAttendancePercentage() >= 50) {
+            cout << "Status: Warning! Low Attendance ⚠\n";
+        } else {
+            cout << "Status: Critical! Very Low Attendance ✗\n";
+        }
+    }
+
+    // ============================================================
+    // ARRAY PROCESSING - Attendance over a range of class days
+    // ============================================================
+    // Demonstrates: Bit counting (popcount) over each student's record
+    void attendanceForDayRange() {
+        if (students.empty() || totalClassDays == 0) {
+            cout << "No attendance recorded yet!\n";
+            return;
+        }
+        
+        int first, last;
+        cout << "\n--- Attendance for a Range of Class Days ---\n";
+        cout << "Enter first and last class day (1-" << totalClassDays << "): ";
+        cin >> first >> last;
+        if (!cin || first < 1 || last < first || last > totalClassDays) {
+            cin.clear();
+            cout << "Error: Invalid range of class days!\n";
+            return;
+        }
+        printDayRange(first - 1, last);
+    }
+
+    // Print each student's attendance over class days [first, last)
+    void printDayRange(int first, int last) {
+        ReportScope report;
+        if (report.suppressed()) {
+            return;
+        }
+        
+        cout << "\nClass Days " << first + 1 << " to " << last << "\n";
+        cout << left << setw(10) << "ID"
+             << setw(25) << "Name"
+             << setw(15) << "Attended"
+             << setw(15) << "Percentage" << "\n";
+        cout << string(65, '-') << "\n";
+        
+        long long attended = 0, held = 0;
+        for (const auto& student : students) {
+            // Clamp to the days this student's record holds
+            int studentLast = min(last, student.getTotalClasses());
+            int present = student.getAttendance().countPresent(first, studentLast);
+            attended += present;
+            held += max(0, studentLast - first);
+            cout << left << setw(10) << student.getId()
+                 << setw(25) << student.getName()
+                 << setw(15) << present
+                 << setw(15) << fixed << setprecision(2)
+                 << student.getAttendancePercentage(first, studentLast) << "%\n";
         }
+        cout << string(65, '-') << "\n";
+        cout << "Overall: " << attended << " of " << held << " student-days ("
+             << fixed << setprecision(2) << (held > 0 ? 100.0 * attended / held : 0.0) << "%)\n";
     }
 
     // ============================================================
@@ -290,116 +1655,168 @@ public:
             return;
         }
         
-        cout << "\n" << string(80, '=') << "\n";
-        cout << "                     ATTENDANCE REPORT\n";
-        cout << string(80, '=') << "\n";
+        // One pass computes every row; both outputs render from it
+        ReportData report = buildReport();
+        printReport(report);
+        
+        // Save report to file (FILE HANDLING)
+        saveReportToFile(report);
+    }
+
+    // ============================================================
+    // REPORT AGGREGATION - One pass over all students
+    // ============================================================
+    enum ReportStatus : uint8_t { STATUS_GOOD, STATUS_LOW, STATUS_CRITICAL };
+
+    // One report line, computed once and rendered by every output
+    struct ReportRow {
+        const Student* student;
+        int attended;
+        double percentage;
+        ReportStatus status;
+    };
+
+    struct ReportData {
+        vector<ReportRow> rows;
+        int good = 0, low = 0, critical = 0;
+    };
+
+    // Below this many students per thread, threads cost more than they save
+    static const size_t REPORT_ROWS_PER_THREAD = 16384;
+
+    // Split [0, count) into one chunk per thread and run work(chunk, begin,
+    // end) for each, the first chunk on the calling thread
+    // Returns the number of chunks
+    template <typename Work>
+    static size_t runInChunks(size_t count, Work work) {
+        size_t threads = max<size_t>(1, thread::hardware_concurrency());
+        threads = max<size_t>(1, min(threads, count / REPORT_ROWS_PER_THREAD));
+        size_t chunk = (count + threads - 1) / threads;
+        vector<thread> workers;
+        for (size_t t = 1; t < threads; t++) {
+            size_t begin = min(count, t * chunk);
+            workers.emplace_back(work, t, begin, min(count, begin + chunk));
+        }
+        work(0, 0, min(count, chunk));
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        return threads;
+    }
+
+    // ARRAY AGGREGATION: Percentage, status and totals for every student
+    ReportData buildReport() const {
+        ReportData report;
+        report.rows.resize(students.size());
+        vector<int> counts(3 * (thread::hardware_concurrency() + 1), 0);
+        size_t chunks = runInChunks(students.size(), [&](size_t chunk, size_t begin, size_t end) {
+            int tally[3] = {0, 0, 0};
+            for (size_t i = begin; i < end; i++) {
+                const Student& student = students[i];
+                ReportRow& row = report.rows[i];
+                row.student = &student;
+                row.attended = student.getAttendedClasses();
+                row.percentage = student.getTotalClasses() == 0 ? 0.0
+                    : static_cast<double>(row.attended) / student.getTotalClasses() * 100.0;
+                row.status = row.percentage >= 75 ? STATUS_GOOD
+                           : row.percentage >= 50 ? STATUS_LOW : STATUS_CRITICAL;
+                tally[row.status]++;
+            }
+            copy(tally, tally + 3, counts.begin() + 3 * chunk);  // Summed once all are done
+        });
+        for (size_t chunk = 0; chunk < chunks; chunk++) {
+            report.good += counts[3 * chunk + STATUS_GOOD];
+            report.low += counts[3 * chunk + STATUS_LOW];
+            report.critical += counts[3 * chunk + STATUS_CRITICAL];
+        }
+        return report;
+    }
+
+    // Render the table rows of `report`, each thread into its own buffer
+    // The buffers are in row order, ready to be written one after another
+    static vector<string> renderReportRows(const ReportData& report, const char* const statusText[3]) {
+        vector<string> buffers(thread::hardware_concurrency() + 1);
+        size_t chunks = runInChunks(report.rows.size(), [&](size_t chunk, size_t begin, size_t end) {
+            ostringstream out;
+            for (size_t i = begin; i < end; i++) {
+                const ReportRow& row = report.rows[i];
+                out << left << setw(10) << row.student->getId()
+                    << setw(25) << row.student->getName()
+                    << setw(15) << row.student->getTotalClasses()
+                    << setw(15) << row.attended
+                    << setw(15) << fixed << setprecision(2) << row.percentage << "%"
+                    << setw(15) << statusText[row.status] << "\n";
+            }
+            buffers[chunk] = out.str();
+        });
+        buffers.resize(chunks);
+        return buffers;
+    }
+
+    // Report title, date and table header
+    void writeReportHeader(ostream& out) const {
+        out << string(80, '=') << "\n";
+        out << "                     ATTENDANCE REPORT\n";
+        out << string(80, '=') << "\n";
         
         // Get current date and time using ctime library
         time_t now = time(0);
         char* dt = ctime(&now);
-        cout << "Report Generated: " << dt;
-        cout << "Total Class Days: " << totalClassDays << "\n";
-        cout << "Total Students: " << students.size() << "\n\n";
+        out << "Report Generated: " << dt;
+        out << "Total Class Days: " << totalClassDays << "\n";
+        out << "Total Students: " << students.size() << "\n\n";
         
         // Table header
-        cout << left << setw(10) << "ID"
-             << setw(25) << "Name"
-             << setw(15) << "Total Classes"
-             << setw(15) << "Attended"
-             << setw(15) << "Percentage"
-             << setw(15) << "Status" << endl;
+        out << left << setw(10) << "ID"
+            << setw(25) << "Name"
+            << setw(15) << "Total Classes"
+            << setw(15) << "Attended"
+            << setw(15) << "Percentage"
+            << setw(15) << "Status" << "\n";
+        
+        out << string(80, '-') << "\n";
+    }
+
+    // Print the report table and summary to the console
+    // Skipped entirely in quiet mode (the file is still written)
+    void printReport(const ReportData& report) const {
+        ReportScope scope;
+        if (scope.suppressed()) {
+            return;
+        }
         
-        cout << string(80, '-') << endl;
+        cout << "\n";
+        writeReportHeader(cout);
         
         // ARRAY PROCESSING: Display all students
-        // Demonstrates: ARRAY TRAVERSAL for reporting
-        for (const auto& student : students) {
-            cout << left << setw(10) << student.getId()
-                 << setw(25) << student.getName()
-                 << setw(15) << student.getTotalClasses()
-                 << setw(15) << student.getAttendedClasses()
-                 << setw(15) << fixed << setprecision(2) << student.getAttendancePercentage() << "%";
-            
-            // Status indicator
-            if (student.getAttendancePercentage() >= 75) {
-                cout << setw(15) << "Good ✓";
-            } else if (student.getAttendancePercentage() >= 50) {
-                cout << setw(15) << "Low ⚠";
-            } else {
-                cout << setw(15) << "Critical ✗";
-            }
-            cout << endl;
+        static const char* const STATUS_TEXT[3] = {"Good ✓", "Low ⚠", "Critical ✗"};
+        for (const string& buffer : renderReportRows(report, STATUS_TEXT)) {
+            cout << buffer;
         }
         
-        // ARRAY PROCESSING: Calculate statistics
-        // Demonstrates: ARRAY AGGREGATION
         cout << "\n" << string(80, '=') << "\n";
         cout << "SUMMARY:\n";
-        
-        int good = 0, low = 0, critical = 0;
-        for (const auto& student : students) {
-            double percentage = student.getAttendancePercentage();
-            if (percentage >= 75) good++;
-            else if (percentage >= 50) low++;
-            else critical++;
-        }
-        
-        cout << "Students with Good Attendance (≥75%): " << good << "\n";
-        cout << "Students with Low Attendance (50-74%): " << low << "\n";
-        cout << "Students with Critical Attendance (<50%): " << critical << "\n";
+        cout << "Students with Good Attendance (≥75%): " << report.good << "\n";
+        cout << "Students with Low Attendance (50-74%): " << report.low << "\n";
+        cout << "Students with Critical Attendance (<50%): " << report.critical << "\n";
         cout << string(80, '=') << "\n";
-        
-        // Save report to file (FILE HANDLING)
-        saveReportToFile();
     }
 
     // ============================================================
     // FILE HANDLING CONCEPT - Save report to file
     // ============================================================
     // Demonstrates: File output with formatted data
-    void saveReportToFile() {
+    void saveReportToFile(const ReportData& report) const {
         ofstream reportFile("attendance_report.txt");  // Open report file
         
         if (reportFile.is_open()) {
             // Write formatted report to file
-            reportFile << string(80, '=') << "\n";
-            reportFile << "                     ATTENDANCE REPORT\n";
-            reportFile << string(80, '=') << "\n";
+            writeReportHeader(reportFile);
             
-            // Write timestamp
-            time_t now = time(0);
-            char* dt = ctime(&now);
-            reportFile << "Report Generated: " << dt;
-            reportFile << "Total Class Days: " << totalClassDays << "\n";
-            reportFile << "Total Students: " << students.size() << "\n\n";
-            
-            // Write table header
-            reportFile << left << setw(10) << "ID"
-                      << setw(25) << "Name"
-                      << setw(15) << "Total Classes"
-                      << setw(15) << "Attended"
-                      << setw(15) << "Percentage"
-                      << setw(15) << "Status" << endl;
-            
-            reportFile << string(80, '-') << endl;
-            
-            // Write all student data (ARRAY TRAVERSAL for file output)
-            for (const auto& student : students) {
-                reportFile << left << setw(10) << student.getId()
-                          << setw(25) << student.getName()
-                          << setw(15) << student.getTotalClasses()
-                          << setw(15) << student.getAttendedClasses()
-                          << setw(15) << fixed << setprecision(2) << student.getAttendancePercentage() << "%";
-                
-                // Write status
-                if (student.getAttendancePercentage() >= 75) {
-                    reportFile << setw(15) << "Good";
-                } else if (student.getAttendancePercentage() >= 50) {
-                    reportFile << setw(15) << "Low";
-                } else {
-                    reportFile << setw(15) << "Critical";
-                }
-                reportFile << endl;
+            // Write all student data, rendered in parallel
+            static const char* const STATUS_TEXT[3] = {"Good", "Low", "Critical"};
+            for (const string& buffer : renderReportRows(report, STATUS_TEXT)) {
+                reportFile.write(buffer.data(), static_cast<streamsize>(buffer.size()));
             }
             
             reportFile.close();  // Close file
@@ -416,14 +1833,18 @@ public:
             cout << "No students registered yet!\n";
             return;
         }
+        ReportScope report;
+        if (report.suppressed()) {
+            return;  // Quiet mode - no report rendering
+        }
         
         cout << "\n--- All Registered Students ---\n";
         cout << left << setw(10) << "ID" 
              << setw(25) << "Name" 
              << setw(15) << "Total Classes" 
              << setw(15) << "Attended" 
-             << setw(15) << "Percentage" << endl;
-        cout << string(70, '-') << endl;
+             << setw(15) << "Percentage" << "\n";
+        cout << string(70, '-') << "\n";
         
         // Loop through array and call each student's display method
         for (const auto& student : students) {
@@ -443,18 +1864,525 @@ public:
         cout << "5. Display All Students\n";
         cout << "6. Save Data\n";
         cout << "7. Load Data\n";
-        cout << "8. Exit\n";
+        cout << "8. Attendance for a Range of Days\n";
+        cout << "9. Exit\n";
         cout << string(50, '-') << "\n";
-        cout << "Enter your choice (1-8): ";
+        cout << "Enter your choice (1-9): ";
     }
 };
 
+// ============================================================
+// BENCHMARKS - Run with: ./main --bench <name> [options]
+// ============================================================
+
+// Rendering cost of generateReport: flushing every line (what `<< endl`
+// used to do) versus the buffered console and quiet mode.
+// The report goes to stdout, so redirect it: ./main --bench report > /dev/null
+int benchmarkReport(int rows) {
+    BufferedConsole* console = BufferedConsole::instance();
+    AttendanceSystem system(false);
+    for (int i = 0; i < rows; i++) {
+        system.addStudent(Student(i + 1, "Student " + to_string(i + 1), 40, i % 41));
+    }
+
+    const char* modes[] = {"flush every line (before)", "buffered (after)", "quiet"};
+    for (int mode = 0; mode < 3; mode++) {
+        console->setFlushEachLine(mode == 0);
+        console->setQuiet(mode == 2);
+
+        auto start = chrono::steady_clock::now();
+        system.generateReport();
+        cout.flush();
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+        cerr << left << setw(30) << modes[mode] << fixed << setprecision(3)
+             << seconds * 1000 << " ms for " << rows << " rows\n";
+    }
+    console->setFlushEachLine(false);
+    console->setQuiet(false);
+    return 0;
+}
+
+// Range queries over per-day attendance bitmaps: counting days one bit at a
+// time versus popcount over whole words, for the whole semester and for
+// random ranges of class days. Both methods must agree.
+int benchmarkRange(int studentCount, int days) {
+    const int QUERIES = 20;
+    vector<Student> students;
+    students.reserve(static_cast<size_t>(studentCount));
+    mt19937 rng(42);
+    for (int i = 0; i < studentCount; i++) {
+        Student student(i + 1, "Student " + to_string(i + 1));
+        for (int day = 0; day < days; day++) {
+            student.markAttendance(rng() % 100 < 80);
+        }
+        students.push_back(student);
+    }
+    vector<pair<int, int>> ranges(1, make_pair(0, days));
+    for (int q = 1; q < QUERIES; q++) {
+        int first = static_cast<int>(rng() % static_cast<unsigned>(days));
+        int last = first + 1 + static_cast<int>(rng() % static_cast<unsigned>(days - first));
+        ranges.push_back(make_pair(first, last));
+    }
+
+    size_t bytes = students.empty() ? 0 : students[0].getAttendance().byteSize();
+    cout << studentCount << " students, " << days << " class days, " << bytes
+         << " bytes of attendance per student\n\n";
+    cout << left << setw(24) << "METHOD" << setw(18) << "STUDENT-DAYS/SEC" << "PRESENT\n";
+    cout << string(50, '-') << "\n";
+    long long totals[2] = {0, 0};
+    for (int method = 0; method < 2; method++) {
+        long long studentDays = 0;
+        auto start = chrono::steady_clock::now();
+        for (const auto& range : ranges) {
+            for (const auto& student : students) {
+                const AttendanceBitmap& attendance = student.getAttendance();
+                if (method == 0) {
+                    for (int day = range.first; day < range.second; day++) {
+                        totals[0] += attendance.get(day);
+                    }
+                } else {
+                    totals[1] += attendance.countPresent(range.first, range.second);
+                }
+                studentDays += range.second - range.first;
+            }
+        }
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        cout << setw(24) << (method == 0 ? "bit by bit" : "popcount") << setw(18) << fixed
+             << setprecision(0) << studentDays / seconds << totals[method] << "\n";
+    }
+    bool ok = totals[0] == totals[1];
+    cout << "\nResults: " << (ok ? "consistent" : "MISMATCH") << "\n";
+    return ok ? 0 : 1;
+}
+
+// Saving and loading `studentCount` students with `days` class days each:
+// the text format (now import/export) versus the binary data file. Both
+// must load back the same students.
+int benchmarkPersist(int studentCount, int days) {
+    const string TEXT_PATH = "bench_attendance.txt";
+    const string BINARY_PATH = "bench_attendance.bin";
+    AttendanceSystem system(false);
+    mt19937 rng(42);
+    for (int i = 0; i < studentCount; i++) {
+        Student student(i + 1, "Student " + to_string(i + 1));
+        for (int day = 0; day < days; day++) {
+            student.markAttendance(rng() % 100 < 80);
+        }
+        system.addStudent(student);
+    }
+    auto seconds = [](chrono::steady_clock::time_point start) {
+        return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    };
+    auto fileSize = [](const string& path) {
+        struct stat info;
+        return stat(path.c_str(), &info) == 0 ? static_cast<long long>(info.st_size) : -1LL;
+    };
+    // Same ids, names and days in the same order
+    auto sameStudents = [&system](const vector<Student>& loaded) {
+        const vector<Student>& original = system.getStudents();
+        if (loaded.size() != original.size()) return false;
+        for (size_t i = 0; i < loaded.size(); i++) {
+            const AttendanceBitmap& a = loaded[i].getAttendance();
+            const AttendanceBitmap& b = original[i].getAttendance();
+            if (loaded[i].getId() != original[i].getId() || loaded[i].getName() != original[i].getName() ||
+                a.size() != b.size() || memcmp(a.data(), b.data(), a.byteSize()) != 0) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    auto start = chrono::steady_clock::now();
+    bool ok = system.exportText(TEXT_PATH);
+    double textSave = seconds(start);
+    AttendanceSystem textCopy(false);
+    start = chrono::steady_clock::now();
+    ok = textCopy.importText(TEXT_PATH) && ok;
+    double textLoad = seconds(start);
+    ok = sameStudents(textCopy.getStudents()) && ok;
+
+    start = chrono::steady_clock::now();
+    ok = AttendanceFile::write(BINARY_PATH, days, system.getStudents()) && ok;
+    double binarySave = seconds(start);
+    vector<Student> binaryCopy;
+    int loadedDays = 0;
+    start = chrono::steady_clock::now();
+    ok = AttendanceFile::read(BINARY_PATH, binaryCopy, loadedDays) && ok;
+    double binaryLoad = seconds(start);
+    ok = sameStudents(binaryCopy) && loadedDays == days && ok;
+
+    cout << studentCount << " students, " << days << " class days\n\n";
+    cout << left << setw(20) << "FORMAT" << setw(14) << "SAVE ms" << setw(14) << "LOAD ms" << "FILE BYTES\n";
+    cout << string(62, '-') << "\n";
+    cout << setw(20) << "text (before)" << setw(14) << fixed << setprecision(1) << textSave * 1000
+         << setw(14) << textLoad * 1000 << fileSize(TEXT_PATH) << "\n";
+    cout << setw(20) << "binary + mmap" << setw(14) << binarySave * 1000
+         << setw(14) << binaryLoad * 1000 << fileSize(BINARY_PATH) << "\n";
+    cout << "\nRound trip: " << (ok ? "identical" : "MISMATCH") << "\n";
+    unlink(TEXT_PATH.c_str());
+    unlink(BINARY_PATH.c_str());
+    return ok ? 0 : 1;
+}
+
+// Cost of a save after a small change with `studentCount` students:
+// rewriting every student (what each save did before) versus appending the
+// change to the log. Then `days` class days are marked and saved one by
+// one, compacting the log in the background whenever it grows too large.
+// Reloading the data file plus the log must give back the same students.
+int benchmarkIncremental(int studentCount, int days) {
+    const string PREFIX = "bench_incremental";
+    auto removeFiles = [&PREFIX]() {
+        unlink((PREFIX + ".bin").c_str());
+        unlink((PREFIX + ".log").c_str());
+        unlink((PREFIX + ".log.old").c_str());
+    };
+    auto elapsedMs = [](chrono::steady_clock::time_point start) {
+        return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    };
+    removeFiles();
+    mt19937 rng(42);
+    auto randomDay = [&rng](size_t count) {
+        vector<bool> present(count);
+        for (size_t i = 0; i < count; i++) present[i] = rng() % 100 < 80;
+        return present;
+    };
+
+    AttendanceSystem system(false, PREFIX);
+    for (int i = 0; i < studentCount; i++) {
+        system.addStudent(Student(i + 1, "Student " + to_string(i + 1)));
+    }
+    for (int day = 0; day < 40; day++) {
+        system.recordClassDay(randomDay(system.getStudents().size()));
+    }
+    bool ok = true;
+    auto start = chrono::steady_clock::now();
+    ok = system.save() && ok;  // No data file yet: writes everything
+    double fullMs = elapsedMs(start);
+
+    system.addStudent(Student(studentCount + 1, "New Student"));
+    start = chrono::steady_clock::now();
+    ok = system.save() && ok;
+    double registerMs = elapsedMs(start);
+
+    system.recordClassDay(randomDay(system.getStudents().size()));
+    start = chrono::steady_clock::now();
+    ok = system.save() && ok;
+    double dayMs = elapsedMs(start);
+
+    double totalMs = 0, worstMs = 0;
+    for (int day = 0; day < days; day++) {
+        system.recordClassDay(randomDay(system.getStudents().size()));
+        start = chrono::steady_clock::now();
+        ok = system.save() && ok;
+        double ms = elapsedMs(start);
+        totalMs += ms;
+        worstMs = max(worstMs, ms);
+    }
+
+    cout << studentCount << " students\n\n";
+    cout << left << setw(34) << "SAVE" << "ms\n";
+    cout << string(44, '-') << "\n";
+    cout << fixed << setprecision(2);
+    cout << setw(34) << "every student (before)" << fullMs << "\n";
+    cout << setw(34) << "after registering one student" << registerMs << "\n";
+    cout << setw(34) << "after marking one class day" << dayMs << "\n";
+    cout << setw(34) << ("mean of " + to_string(days) + " class days") << (days > 0 ? totalMs / days : 0.0) << "\n";
+    cout << setw(34) << "worst (incl. compaction start)" << worstMs << "\n";
+
+    // The compactor may still be rewriting the data file
+    system.waitForCompaction();
+    {
+        AttendanceSystem reloaded(false, PREFIX);
+        reloaded.loadFromFile();
+        const vector<Student>& a = system.getStudents();
+        const vector<Student>& b = reloaded.getStudents();
+        ok = ok && a.size() == b.size() && reloaded.getTotalClassDays() == system.getTotalClassDays();
+        for (size_t i = 0; ok && i < a.size(); i++) {
+            ok = a[i].getId() == b[i].getId() && a[i].getName() == b[i].getName() &&
+                 a[i].getTotalClasses() == b[i].getTotalClasses() &&
+                 memcmp(a[i].getAttendance().data(), b[i].getAttendance().data(),
+                        a[i].getAttendance().byteSize()) == 0;
+        }
+    }
+    cout << "\nReload: " << (ok ? "identical" : "MISMATCH") << "\n";
+    removeFiles();
+    return ok ? 0 : 1;
+}
+
+// Registering 1k, 10k .. `studentCount` students one at a time, each after
+// a duplicate-ID check: a linear scan over the students (before, O(N^2) in
+// total, only run up to 10k) versus the hash index. Registering every ID
+// a second time must be refused for all of them.
+int benchmarkRegister(int studentCount) {
+    const int LINEAR_LIMIT = 10000;
+    cout << left << setw(12) << "STUDENTS" << setw(18) << "LINEAR SCAN ms" << setw(18) << "HASH INDEX ms"
+         << "DUPLICATES REFUSED\n";
+    cout << string(66, '-') << "\n";
+    bool ok = true;
+    for (int n = 1000; n <= studentCount; n *= 10) {
+        // Scattered IDs, as real student numbers are
+        vector<int> ids(static_cast<size_t>(n));
+        for (int i = 0; i < n; i++) {
+            ids[static_cast<size_t>(i)] = static_cast<int>((static_cast<uint32_t>(i) * 2654435761u) & 0x7FFFFFFF);
+        }
+
+        string linearText = "skipped";
+        if (n <= LINEAR_LIMIT) {
+            vector<Student> students;
+            auto start = chrono::steady_clock::now();
+            for (int id : ids) {
+                bool exists = false;
+                for (const auto& student : students) {
+                    if (student.getId() == id) {
+                        exists = true;
+                        break;
+                    }
+                }
+                if (!exists) {
+                    students.push_back(Student(id, "Student"));
+                }
+            }
+            double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+            ostringstream text;
+            text << fixed << setprecision(1) << ms;
+            linearText = text.str();
+        }
+
+        AttendanceSystem system(false);
+        auto start = chrono::steady_clock::now();
+        for (int id : ids) {
+            system.addStudent(Student(id, "Student"));
+        }
+        double indexMs = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+        int refused = 0;
+        for (int id : ids) {
+            refused += !system.addStudent(Student(id, "Student"));
+        }
+        for (size_t i = 0; i < ids.size() && ok; i += 97) {
+            const Student* student = system.findStudent(ids[i]);
+            ok = student != nullptr && student->getId() == ids[i];
+        }
+        ok = ok && refused == n && system.getStudents().size() == ids.size();
+
+        cout << setw(12) << n << setw(18) << linearText << setw(18) << fixed << setprecision(1)
+             << indexMs << refused << "\n";
+    }
+    cout << "\nIndex: " << (ok ? "consistent" : "MISMATCH") << "\n";
+    return ok ? 0 : 1;
+}
+
+// Ingesting `eventCount` scanner events for `studentCount` students over
+// 200 class days, read from a CSV file and from a binary stream. The binary
+// stream is also applied in arrival order (one scattered bitmap write per
+// event) instead of the sorted merge. All three must give the same students.
+// First, CSV files with lone-\r line ends and with a line longer than the
+// read buffer must parse to the expected events.
+int benchmarkScan(int eventCount, int studentCount) {
+    const string CSV_PATH = "bench_scans.csv";
+    const string BINARY_PATH = "bench_scans.bin";
+    const int DAYS = 200;
+
+    // LINE ENDINGS: 200k lines (over 1 MiB) ending in \r, then the same
+    // with a 3 MiB line without any line end in the middle
+    auto readAll = [](const string& text, const string& path, uint64_t& malformed) {
+        ofstream file(path, ios::binary);
+        file.write(text.data(), static_cast<streamsize>(text.size()));
+        file.close();
+        ScanEventReader reader(path);
+        vector<ScanEvent> all, batch;
+        while (reader.next(batch, 4096)) {
+            all.insert(all.end(), batch.begin(), batch.end());
+        }
+        malformed = reader.getMalformed();
+        unlink(path.c_str());
+        return all;
+    };
+    string carriageReturns;
+    for (int i = 0; i < 200000; i++) {
+        carriageReturns += to_string(i + 1) + ",1,P\r";
+    }
+    uint64_t malformed = 0;
+    vector<ScanEvent> parsed = readAll(carriageReturns, CSV_PATH, malformed);
+    bool linesOk = parsed.size() == 200000 && malformed == 0 && parsed.back().studentId == 200000;
+    string overlong = "1,1,P\r\n" + string(3 << 20, '7') + "\n2,2,A\n3,3,P";
+    parsed = readAll(overlong, CSV_PATH, malformed);
+    linesOk = linesOk && parsed.size() == 3 && malformed == 1 && parsed[1].studentId == 2 &&
+              parsed[2].classDay == 3;
+    cout << "Line endings: " << (linesOk ? "ok" : "WRONG") << "\n";
+    if (!linesOk) {
+        return 1;
+    }
+
+    mt19937 rng(42);
+    vector<int> ids(static_cast<size_t>(studentCount));
+    for (int i = 0; i < studentCount; i++) {
+        ids[static_cast<size_t>(i)] = static_cast<int>((static_cast<uint32_t>(i) * 2654435761u) & 0x7FFFFFFF);
+    }
+    vector<ScanEvent> events(static_cast<size_t>(eventCount));
+    for (ScanEvent& event : events) {
+        memset(&event, 0, sizeof(event));
+        event.studentId = ids[rng() % ids.size()];
+        event.classDay = static_cast<int32_t>(rng() % DAYS) + 1;
+        event.present = rng() % 100 < 80;
+    }
+
+    string csv = "student_id,class_day,present\n";
+    csv.reserve(events.size() * 16);
+    for (const ScanEvent& event : events) {
+        csv += to_string(event.studentId);
+        csv += ',';
+        csv += to_string(event.classDay);
+        csv += event.present ? ",P\n" : ",A\n";
+    }
+    ofstream csvFile(CSV_PATH, ios::binary);
+    csvFile.write(csv.data(), static_cast<streamsize>(csv.size()));
+    csvFile.close();
+    bool ok = csvFile.good() && ScanEventReader::writeBinary(BINARY_PATH, events);
+    cout << eventCount << " events, " << studentCount << " students, " << DAYS << " class days\n";
+    cout << "CSV " << csv.size() / (1 << 20) << " MiB, binary "
+         << (events.size() * sizeof(ScanEvent)) / (1 << 20) << " MiB\n\n";
+    string().swap(csv);
+
+    auto ingest = [&](const string& path, bool sorted, AttendanceSystem& system) {
+        for (int id : ids) {
+            system.addStudent(Student(id, "Student"));
+        }
+        ScanEventReader reader(path);
+        ScanImportSummary summary = system.importScans(reader, sorted);
+        ok = ok && reader.isOpen() && summary.applied == events.size() && summary.invalid == 0;
+        return summary;
+    };
+    AttendanceSystem fromCsv(false), fromBinary(false), unsorted(false);
+    ScanImportSummary results[3] = {
+        ingest(CSV_PATH, true, fromCsv),
+        ingest(BINARY_PATH, true, fromBinary),
+        ingest(BINARY_PATH, false, unsorted)
+    };
+    const char* labels[3] = {"CSV, sorted merge", "binary, sorted merge", "binary, arrival order"};
+
+    cout << left << setw(26) << "INGEST" << setw(12) << "s" << "events/sec\n";
+    cout << string(50, '-') << "\n";
+    for (int i = 0; i < 3; i++) {
+        cout << setw(26) << labels[i] << setw(12) << fixed << setprecision(3) << results[i].seconds
+             << setprecision(0) << results[i].events / results[i].seconds << "\n";
+    }
+
+    for (const AttendanceSystem* other : {&fromBinary, &unsorted}) {
+        const vector<Student>& a = fromCsv.getStudents();
+        const vector<Student>& b = other->getStudents();
+        ok = ok && a.size() == b.size() && other->getTotalClassDays() == fromCsv.getTotalClassDays();
+        for (size_t i = 0; ok && i < a.size(); i++) {
+            ok = a[i].getTotalClasses() == b[i].getTotalClasses() &&
+                 memcmp(a[i].getAttendance().data(), b[i].getAttendance().data(),
+                        a[i].getAttendance().byteSize()) == 0;
+        }
+    }
+    cout << "\nResults: " << (ok ? "identical" : "MISMATCH") << "\n";
+    unlink(CSV_PATH.c_str());
+    unlink(BINARY_PATH.c_str());
+    return ok ? 0 : 1;
+}
+
+// Function to select a benchmark by name
+int runBenchmark(const string& name, int argc, char* argv[]) {
+    if (name == "report") {
+        int rows = argc > 0 ? atoi(argv[0]) : 100000;
+        return benchmarkReport(rows);
+    }
+    if (name == "range") {
+        int studentCount = argc > 0 ? atoi(argv[0]) : 100000;
+        int days = argc > 1 ? atoi(argv[1]) : 200;
+        return benchmarkRange(studentCount, max(1, days));
+    }
+    if (name == "incremental") {
+        int studentCount = argc > 0 ? atoi(argv[0]) : 500000;
+        int days = argc > 1 ? atoi(argv[1]) : 200;
+        return benchmarkIncremental(studentCount, max(0, days));
+    }
+    if (name == "register") {
+        int studentCount = argc > 0 ? atoi(argv[0]) : 1000000;
+        return benchmarkRegister(studentCount);
+    }
+    if (name == "persist") {
+        int studentCount = argc > 0 ? atoi(argv[0]) : 500000;
+        int days = argc > 1 ? atoi(argv[1]) : 200;
+        return benchmarkPersist(studentCount, max(0, days));
+    }
+    if (name == "scan") {
+        int eventCount = argc > 0 ? atoi(argv[0]) : 10000000;
+        int studentCount = argc > 1 ? atoi(argv[1]) : 100000;
+        return benchmarkScan(max(0, eventCount), max(1, studentCount));
+    }
+    cout << "Unknown benchmark: " << name << "\n";
+    cout << "Available: report [rows], range [students] [days], persist [students] [days], "
+         << "incremental [students] [days], register [students], scan [events] [students]\n";
+    return 1;
+}
+
 // ============================================================
 // MAIN FUNCTION - Program Entry Point
 // ============================================================
-int main() {
+int main(int argc, char* argv[]) {
+    // Buffer all console output, flushed at prompts and on exit
+    // Declared first so it is destroyed last, after the final save message
+    BufferedConsole console;
+
+    // Benchmark mode instead of the interactive simulation
+    if (argc >= 3 && string(argv[1]) == "--bench") {
+        return runBenchmark(argv[2], argc - 3, argv + 3);
+    }
+
+    // Command line options
+    string importPath, exportPath, scanPath;
+    for (int i = 1; i < argc; i++) {
+        string option = argv[i];
+        if (option == "--quiet") {
+            console.setQuiet(true);  // Skip report rendering
+        } else if (option == "--import" && i + 1 < argc) {
+            importPath = argv[++i];  // Replace the data with a text file
+        } else if (option == "--export" && i + 1 < argc) {
+            exportPath = argv[++i];  // Write the data as text and exit
+        } else if (option == "--scan" && i + 1 < argc) {
+            scanPath = argv[++i];    // Apply scanner events, save and exit
+        } else {
+            cout << "Unknown option: " << option << "\n";
+            cout << "Usage: ./main [--quiet] [--import <file>] [--export <file>] [--scan <file>] | --bench <name> [options]\n";
+            return 1;
+        }
+    }
+
     // CLASS CONCEPT: Creating object of AttendanceSystem class
     AttendanceSystem system;  // Constructor is called here
+
+    // FILE HANDLING: Text import/export around the binary data file
+    if (!importPath.empty()) {
+        if (!system.importText(importPath)) {
+            cout << "Error: Unable to read '" << importPath << "'.\n";
+            return 1;
+        }
+        cout << "Data imported from '" << importPath << "'.\n";
+        system.saveToFile();  // Replaces the data file, even a damaged one
+    }
+    if (!exportPath.empty()) {
+        if (!system.exportText(exportPath)) {
+            cout << "Error: Unable to write '" << exportPath << "'.\n";
+            return 1;
+        }
+        cout << "Data exported to '" << exportPath << "'.\n";
+        return 0;
+    }
+    if (!scanPath.empty()) {
+        ScanEventReader reader(scanPath);
+        if (!reader.isOpen()) {
+            cout << "Error: Unable to read scans from '" << scanPath << "'.\n";
+            return 1;
+        }
+        cout << "Importing " << (reader.isBinary() ? "binary" : "CSV") << " scans from '"
+             << scanPath << "'...\n";
+        AttendanceSystem::displayScanSummary(system.importScans(reader));
+        return 0;  // Saved by the destructor
+    }
     
     int choice;
     
@@ -490,6 +2418,9 @@ int main() {
                 system.loadFromFile();  // FILE HANDLING: Load data
                 break;
             case 8:
+                system.attendanceForDayRange();  // ARRAY: Count bits per student
+                break;
+            case 9:
                 cout << "\nThank you for using the Attendance Management System!\n";
                 cout << "Goodbye!\n";
                 break;
@@ -501,7 +2432,7 @@ int main() {
         cin.ignore();
         cin.get();
         
-    } while(choice != 8);
+    } while(choice != 9);
     
     // Destructor is automatically called here to save data
     return 0;
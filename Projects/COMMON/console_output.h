@@ -0,0 +1,209 @@
+/*
+CONSOLE OUTPUT - Buffered stdout shared by the simulators
+Collects everything written to cout in one large buffer and hands it to the
+OS with a single write() when the buffer fills, when the program is about to
+read input (cin is tied to cout, so prompts are always visible), or at exit.
+*/
+
+#ifndef COMMON_CONSOLE_OUTPUT_H
+#define COMMON_CONSOLE_OUTPUT_H
+
+#include <cerrno>
+#include <cstddef>
+#include <iostream>
+#include <streambuf>
+#include <vector>
+#include <unistd.h>
+
+// ============================================================
+// BufferedConsole - RAII owner of the cout buffer
+// ============================================================
+// Create one at the top of main(), before any object that prints from its
+// destructor, so its own destructor runs last and flushes everything.
+class BufferedConsole : public std::streambuf {
+private:
+    std::vector<char> buffer;
+    std::streambuf* previous;   // cout's original buffer, restored at exit
+    bool quiet;                 // Drop report output (see ReportScope)
+    int reportDepth;            // Number of ReportScopes currently open
+    bool flushEachLine;         // Emulates endl-everywhere output (benchmarks)
+    size_t lineFill;            // Bytes held in flush-each-line mode
+
+    static BufferedConsole*& current() {
+        static BufferedConsole* console = nullptr;
+        return console;
+    }
+
+    bool muted() const { return quiet && reportDepth > 0; }
+
+    // Normally characters go straight into the put area. While muted or in
+    // flush-each-line mode the put area is empty, so every character passes
+    // through overflow()/xsputn() where it can be dropped or line-flushed.
+    void resetPutArea() {
+        if (muted() || flushEachLine) {
+            setp(nullptr, nullptr);
+        } else {
+            setp(buffer.data(), buffer.data() + buffer.size());
+        }
+    }
+
+    bool writeAll(const char* data, size_t bytes) {
+        while (bytes > 0) {
+            ssize_t written = ::write(STDOUT_FILENO, data, bytes);
+            if (written < 0) {
+                if (errno == EINTR) continue;
+                return false;
+            }
+            data += written;
+            bytes -= static_cast<size_t>(written);
+        }
+        return true;
+    }
+
+    // Flush-each-line mode: store one character, write the line at '\n'
+    bool putLineChar(char c) {
+        if (lineFill == buffer.size() && !flush()) {
+            return false;
+        }
+        buffer[lineFill++] = c;
+        return c != '\n' || flush();
+    }
+
+protected:
+    int_type overflow(int_type ch) override {
+        if (traits_type::eq_int_type(ch, traits_type::eof()) || muted()) {
+            return traits_type::not_eof(ch);
+        }
+        char c = traits_type::to_char_type(ch);
+        if (flushEachLine) {
+            return putLineChar(c) ? ch : traits_type::eof();
+        }
+        if (!flush()) {
+            return traits_type::eof();
+        }
+        *pptr() = c;
+        pbump(1);
+        return ch;
+    }
+
+    std::streamsize xsputn(const char* data, std::streamsize count) override {
+        if (muted()) {
+            return count;
+        }
+        if (flushEachLine) {
+            for (std::streamsize i = 0; i < count; i++) {
+                if (!putLineChar(data[i])) return i;
+            }
+            return count;
+        }
+        std::streamsize remaining = count;
+        while (remaining > 0) {
+            std::streamsize room = epptr() - pptr();
+            if (room == 0) {
+                if (!flush()) break;
+                continue;
+            }
+            std::streamsize chunk = remaining < room ? remaining : room;
+            traits_type::copy(pptr(), data, static_cast<size_t>(chunk));
+            pbump(static_cast<int>(chunk));
+            data += chunk;
+            remaining -= chunk;
+        }
+        return count - remaining;
+    }
+
+    // Called by cout.flush() and by cin before it reads (tie)
+    int sync() override {
+        return flush() ? 0 : -1;
+    }
+
+public:
+    explicit BufferedConsole(size_t capacity = 1 << 20)
+        : buffer(capacity), previous(nullptr), quiet(false), reportDepth(0),
+          flushEachLine(false), lineFill(0) {
+        resetPutArea();
+        previous = std::cout.rdbuf(this);
+        current() = this;
+    }
+
+    ~BufferedConsole() {
+        flush();
+        std::cout.rdbuf(previous);
+        current() = nullptr;
+    }
+
+    BufferedConsole(const BufferedConsole&) = delete;
+    BufferedConsole& operator=(const BufferedConsole&) = delete;
+
+    // The console installed by main(), or nullptr
+    static BufferedConsole* instance() { return current(); }
+
+    // Write everything buffered so far with one write() call
+    bool flush() {
+        // Buffered bytes always start at buffer[0], whichever mode is active
+        size_t pending = lineFill + static_cast<size_t>(pptr() - pbase());
+        bool ok = pending == 0 || writeAll(buffer.data(), pending);
+        lineFill = 0;
+        resetPutArea();
+        return ok;
+    }
+
+    void setQuiet(bool enabled) {
+        flush();
+        quiet = enabled;
+        resetPutArea();
+    }
+    bool isQuiet() const { return quiet; }
+
+    // Flush after every line, like the old `<< endl` style (for comparisons)
+    void setFlushEachLine(bool enabled) {
+        flush();
+        flushEachLine = enabled;
+        resetPutArea();
+    }
+
+    void beginReport() {
+        if (quiet && reportDepth == 0) {
+            flush();
+        }
+        reportDepth++;
+        if (quiet) {
+            resetPutArea();
+        }
+    }
+
+    void endReport() {
+        reportDepth--;
+        if (quiet && reportDepth == 0) {
+            resetPutArea();
+        }
+    }
+};
+
+// ============================================================
+// ReportScope - marks report rendering that quiet mode suppresses
+// ============================================================
+class ReportScope {
+public:
+    ReportScope() {
+        if (BufferedConsole::instance() != nullptr) {
+            BufferedConsole::instance()->beginReport();
+        }
+    }
+
+    ~ReportScope() {
+        if (BufferedConsole::instance() != nullptr) {
+            BufferedConsole::instance()->endReport();
+        }
+    }
+
+    // True when quiet mode is on - callers can skip building the report
+    bool suppressed() const {
+        return BufferedConsole::instance() != nullptr && BufferedConsole::instance()->isQuiet();
+    }
+
+    ReportScope(const ReportScope&) = delete;
+    ReportScope& operator=(const ReportScope&) = delete;
+};
+
+#endif
@@ -0,0 +1,136 @@
+/*
+MONEY - Fixed-point currency type shared by the simulators
+Stores whole cents in a 64-bit integer, so sums are exact and never drift
+*/
+
+#ifndef COMMON_MONEY_H
+#define COMMON_MONEY_H
+
+#include <cstdint>
+#include <cmath>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+
+// ============================================================
+// Money class - integer cents with overflow-checked arithmetic
+// ============================================================
+class Money {
+private:
+    int64_t cents;
+
+    constexpr explicit Money(int64_t totalCents) : cents(totalCents) {}
+
+    static constexpr int64_t checkedAdd(int64_t a, int64_t b) {
+        int64_t result = 0;
+        if (__builtin_add_overflow(a, b, &result)) {
+            throw std::overflow_error("Money: addition overflow");
+        }
+        return result;
+    }
+
+    static constexpr int64_t checkedSub(int64_t a, int64_t b) {
+        int64_t result = 0;
+        if (__builtin_sub_overflow(a, b, &result)) {
+            throw std::overflow_error("Money: subtraction overflow");
+        }
+        return result;
+    }
+
+    static constexpr int64_t checkedMul(int64_t a, int64_t b) {
+        int64_t result = 0;
+        if (__builtin_mul_overflow(a, b, &result)) {
+            throw std::overflow_error("Money: multiplication overflow");
+        }
+        return result;
+    }
+
+    // Integer division rounding half away from zero
+    static constexpr int64_t roundedDiv(int64_t numerator, int64_t denominator) {
+        if (denominator < 0) {
+            numerator = -numerator;
+            denominator = -denominator;
+        }
+        int64_t half = denominator / 2;
+        return numerator >= 0 ? (numerator + half) / denominator
+                              : (numerator - half) / denominator;
+    }
+
+public:
+    // Constructor - zero
+    constexpr Money() : cents(0) {}
+
+    // Factory functions
+    static constexpr Money fromCents(int64_t totalCents) { return Money(totalCents); }
+    static constexpr Money dollars(int64_t wholeDollars) {
+        return Money(checkedMul(wholeDollars, 100));
+    }
+
+    // Convert user input, rounding to the nearest cent
+    static Money fromDouble(double amount) {
+        double totalCents = std::round(amount * 100.0);
+        if (!std::isfinite(totalCents) || totalCents >= 9.2e18 || totalCents <= -9.2e18) {
+            throw std::overflow_error("Money: amount out of range");
+        }
+        return Money(static_cast<int64_t>(totalCents));
+    }
+
+    // Getter methods
+    constexpr int64_t getCents() const { return cents; }
+    double toDouble() const { return static_cast<double>(cents) / 100.0; }
+
+    // Scale by numerator/denominator, e.g. scaledBy(25, 100) for 25%
+    constexpr Money scaledBy(int64_t numerator, int64_t denominator) const {
+        return Money(roundedDiv(checkedMul(cents, numerator), denominator));
+    }
+
+    // Arithmetic operators
+    constexpr Money operator+(Money other) const { return Money(checkedAdd(cents, other.cents)); }
+    constexpr Money operator-(Money other) const { return Money(checkedSub(cents, other.cents)); }
+    constexpr Money operator-() const { return Money(checkedSub(0, cents)); }
+    constexpr Money operator*(int64_t factor) const { return Money(checkedMul(cents, factor)); }
+    constexpr Money operator/(int64_t divisor) const { return Money(roundedDiv(cents, divisor)); }
+    constexpr Money& operator+=(Money other) { cents = checkedAdd(cents, other.cents); return *this; }
+    constexpr Money& operator-=(Money other) { cents = checkedSub(cents, other.cents); return *this; }
+
+    // Comparison operators
+    constexpr bool operator==(Money other) const { return cents == other.cents; }
+    constexpr bool operator!=(Money other) const { return cents != other.cents; }
+    constexpr bool operator<(Money other) const { return cents < other.cents; }
+    constexpr bool operator<=(Money other) const { return cents <= other.cents; }
+    constexpr bool operator>(Money other) const { return cents > other.cents; }
+    constexpr bool operator>=(Money other) const { return cents >= other.cents; }
+
+    // Format as "1234.56" (no currency sign)
+    std::string toString() const {
+        uint64_t magnitude = cents < 0 ? 0 - static_cast<uint64_t>(cents)
+                                       : static_cast<uint64_t>(cents);
+        std::string text = std::to_string(magnitude / 100);
+        unsigned fraction = static_cast<unsigned>(magnitude % 100);
+        text += '.';
+        text += static_cast<char>('0' + fraction / 10);
+        text += static_cast<char>('0' + fraction % 10);
+        return cents < 0 ? "-" + text : text;
+    }
+};
+
+// Stream output honours setw/left/right like any other field
+inline std::ostream& operator<<(std::ostream& out, Money amount) {
+    return out << amount.toString();
+}
+
+// Stream input reads a decimal amount such as 12.5 or 100
+inline std::istream& operator>>(std::istream& in, Money& amount) {
+    double value;
+    if (in >> value) {
+        try {
+            amount = Money::fromDouble(value);
+        } catch (const std::overflow_error&) {
+            in.setstate(std::ios::failbit);
+        }
+    }
+    return in;
+}
+
+#endif
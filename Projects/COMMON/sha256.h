@@ -0,0 +1,200 @@
+/*
+SHA-256 - Hashing for stored credentials, shared by the simulators
+Plain SHA-256 (FIPS 180-4), HMAC-SHA256 (RFC 2104) and PBKDF2-HMAC-SHA256
+(RFC 8018) with a caller-chosen iteration count. No external libraries.
+*/
+
+#ifndef COMMON_SHA256_H
+#define COMMON_SHA256_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// ============================================================
+// Sha256 class - incremental hash, 32-byte digest
+// ============================================================
+class Sha256 {
+public:
+    static const size_t DIGEST_SIZE = 32;
+    static const size_t BLOCK_SIZE = 64;
+
+private:
+    uint32_t state[8];
+    uint8_t block[BLOCK_SIZE];
+    size_t blockFill;
+    uint64_t totalBytes;
+
+    static uint32_t rotateRight(uint32_t value, int bits) {
+        return (value >> bits) | (value << (32 - bits));
+    }
+
+    void compress(const uint8_t* data) {
+        static const uint32_t K[64] = {
+            0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+            0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+            0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+            0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+            0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+            0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+            0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+            0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+        };
+
+        uint32_t w[64];
+        for (int i = 0; i < 16; i++) {
+            w[i] = (uint32_t(data[4 * i]) << 24) | (uint32_t(data[4 * i + 1]) << 16) |
+                   (uint32_t(data[4 * i + 2]) << 8) | uint32_t(data[4 * i + 3]);
+        }
+        for (int i = 16; i < 64; i++) {
+            uint32_t s0 = rotateRight(w[i - 15], 7) ^ rotateRight(w[i - 15], 18) ^ (w[i - 15] >> 3);
+            uint32_t s1 = rotateRight(w[i - 2], 17) ^ rotateRight(w[i - 2], 19) ^ (w[i - 2] >> 10);
+            w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+        }
+
+        uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+        uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+        for (int i = 0; i < 64; i++) {
+            uint32_t s1 = rotateRight(e, 6) ^ rotateRight(e, 11) ^ rotateRight(e, 25);
+            uint32_t choice = (e & f) ^ (~e & g);
+            uint32_t t1 = h + s1 + choice + K[i] + w[i];
+            uint32_t s0 = rotateRight(a, 2) ^ rotateRight(a, 13) ^ rotateRight(a, 22);
+            uint32_t majority = (a & b) ^ (a & c) ^ (b & c);
+            uint32_t t2 = s0 + majority;
+            h = g; g = f; f = e; e = d + t1;
+            d = c; c = b; b = a; a = t1 + t2;
+        }
+        state[0] += a; state[1] += b; state[2] += c; state[3] += d;
+        state[4] += e; state[5] += f; state[6] += g; state[7] += h;
+    }
+
+public:
+    Sha256() {
+        static const uint32_t INITIAL[8] = {
+            0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+            0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+        };
+        memcpy(state, INITIAL, sizeof(state));
+        blockFill = 0;
+        totalBytes = 0;
+    }
+
+    void update(const void* data, size_t bytes) {
+        if (bytes == 0) {
+            return; // `data` may be null; memcpy must not see it
+        }
+        const uint8_t* p = static_cast<const uint8_t*>(data);
+        totalBytes += bytes;
+        if (blockFill > 0) {
+            size_t take = BLOCK_SIZE - blockFill < bytes ? BLOCK_SIZE - blockFill : bytes;
+            memcpy(block + blockFill, p, take);
+            blockFill += take;
+            p += take;
+            bytes -= take;
+            if (blockFill < BLOCK_SIZE) {
+                return;
+            }
+            compress(block);
+            blockFill = 0;
+        }
+        while (bytes >= BLOCK_SIZE) {
+            compress(p);
+            p += BLOCK_SIZE;
+            bytes -= BLOCK_SIZE;
+        }
+        memcpy(block, p, bytes);
+        blockFill = bytes;
+    }
+
+    void finish(uint8_t digest[DIGEST_SIZE]) {
+        // Padding: 0x80, zeros, then the message length in bits (big-endian)
+        uint64_t bits = totalBytes * 8;
+        block[blockFill++] = 0x80;
+        if (blockFill > BLOCK_SIZE - 8) {
+            memset(block + blockFill, 0, BLOCK_SIZE - blockFill);
+            compress(block);
+            blockFill = 0;
+        }
+        memset(block + blockFill, 0, BLOCK_SIZE - 8 - blockFill);
+        for (int i = 0; i < 8; i++) {
+            block[BLOCK_SIZE - 8 + i] = static_cast<uint8_t>(bits >> (56 - 8 * i));
+        }
+        compress(block);
+        for (int i = 0; i < 8; i++) {
+            digest[4 * i] = static_cast<uint8_t>(state[i] >> 24);
+            digest[4 * i + 1] = static_cast<uint8_t>(state[i] >> 16);
+            digest[4 * i + 2] = static_cast<uint8_t>(state[i] >> 8);
+            digest[4 * i + 3] = static_cast<uint8_t>(state[i]);
+        }
+    }
+};
+
+// ============================================================
+// HmacSha256 class - keyed hash with reusable key state
+// ============================================================
+// The inner and outer hashes after the padded key are computed once, so
+// each further message costs only the hashing of the message itself
+class HmacSha256 {
+private:
+    Sha256 innerStart;
+    Sha256 outerStart;
+
+public:
+    HmacSha256(const void* key, size_t keyBytes) {
+        uint8_t padded[Sha256::BLOCK_SIZE] = {0};
+        if (keyBytes > Sha256::BLOCK_SIZE) {
+            Sha256 keyHash;
+            keyHash.update(key, keyBytes);
+            keyHash.finish(padded);
+        } else {
+            memcpy(padded, key, keyBytes);
+        }
+        uint8_t pad[Sha256::BLOCK_SIZE];
+        for (size_t i = 0; i < Sha256::BLOCK_SIZE; i++) pad[i] = padded[i] ^ 0x36;
+        innerStart.update(pad, sizeof(pad));
+        for (size_t i = 0; i < Sha256::BLOCK_SIZE; i++) pad[i] = padded[i] ^ 0x5c;
+        outerStart.update(pad, sizeof(pad));
+    }
+
+    // MAC of two concatenated parts (either may be empty)
+    void compute(const void* first, size_t firstBytes, const void* second, size_t secondBytes,
+                 uint8_t mac[Sha256::DIGEST_SIZE]) const {
+        Sha256 inner = innerStart;
+        inner.update(first, firstBytes);
+        inner.update(second, secondBytes);
+        uint8_t innerDigest[Sha256::DIGEST_SIZE];
+        inner.finish(innerDigest);
+        Sha256 outer = outerStart;
+        outer.update(innerDigest, sizeof(innerDigest));
+        outer.finish(mac);
+    }
+};
+
+// PBKDF2-HMAC-SHA256 producing one 32-byte block (dkLen = 32)
+// Cost grows linearly with `iterations`, two SHA-256 compressions each
+inline void pbkdf2HmacSha256(const void* password, size_t passwordBytes,
+                             const void* salt, size_t saltBytes, uint32_t iterations,
+                             uint8_t output[Sha256::DIGEST_SIZE]) {
+    HmacSha256 hmac(password, passwordBytes);
+    const uint8_t blockIndex[4] = {0, 0, 0, 1};
+    uint8_t u[Sha256::DIGEST_SIZE];
+    hmac.compute(salt, saltBytes, blockIndex, sizeof(blockIndex), u);
+    memcpy(output, u, sizeof(u));
+    for (uint32_t i = 1; i < iterations; i++) {
+        hmac.compute(u, sizeof(u), nullptr, 0, u);
+        for (size_t j = 0; j < sizeof(u); j++) {
+            output[j] ^= u[j];
+        }
+    }
+}
+
+// Compare two byte strings in time that depends only on their length
+inline bool constantTimeEquals(const uint8_t* a, const uint8_t* b, size_t bytes) {
+    volatile uint8_t difference = 0;
+    for (size_t i = 0; i < bytes; i++) {
+        difference = difference | (a[i] ^ b[i]);
+    }
+    return difference == 0;
+}
+
+#endif
@@ -15,6 +15,8 @@ Runs in VS Code without any hardware
 #include <algorithm>      // For sorting and algorithms
 #include <ctime>          // For time and date functions
 #include <limits>         // For numeric_limits (FIXED: Added this missing include)
+#include "../../COMMON/money.h"  // Integer-cents Money type (exact salary sums)
+#include "../../COMMON/console_output.h"  // Buffered cout, quiet reports
 
 using namespace std;
 
@@ -32,23 +34,23 @@ private:
     // PRIVATE DATA MEMBERS - Encapsulation principle
     int empID;           // Employee ID
     string empName;      // Employee name
-    double basicSalary;  // Basic salary
-    double allowances;   // Total allowances
-    double deductions;   // Total deductions
-    double grossSalary;  // Gross salary
-    double netSalary;    // Net salary (take-home)
+    Money basicSalary;   // Basic salary
+    Money allowances;    // Total allowances
+    Money deductions;    // Total deductions
+    Money grossSalary;   // Gross salary
+    Money netSalary;     // Net salary (take-home)
 
 public:
     // CONSTRUCTOR - Initializes employee object
     // Demonstrates: Constructor with parameters
-    Employee(int id = 0, string name = "", double basic = 0.0) {
+    Employee(int id = 0, string name = "", Money basic = Money()) {
         empID = id;
         empName = name;
         basicSalary = basic;
-        allowances = 0.0;
-        deductions = 0.0;
-        grossSalary = 0.0;
-        netSalary = 0.0;
+        allowances = Money();
+        deductions = Money();
+        grossSalary = Money();
+        netSalary = Money();
     }
 
     // ============================================================
@@ -57,9 +59,9 @@ public:
     // ============================================================
     int getID() const { return empID; }
     string getName() const { return empName; }
-    double getBasicSalary() const { return basicSalary; }
-    double getGrossSalary() const { return grossSalary; }
-    double getNetSalary() const { return netSalary; }
+    Money getBasicSalary() const { return basicSalary; }
+    Money getGrossSalary() const { return grossSalary; }
+    Money getNetSalary() const { return netSalary; }
 
     // ============================================================
     // SETTER METHODS - Mutator functions
@@ -67,28 +69,28 @@ public:
     // ============================================================
     void setID(int id) { empID = id; }
     void setName(string name) { empName = name; }
-    void setBasicSalary(double basic) { basicSalary = basic; }
+    void setBasicSalary(Money basic) { basicSalary = basic; }
 
     // ============================================================
     // SALARY CALCULATION FUNCTIONS
     // Demonstrates: Member functions performing calculations
     // ============================================================
     
-    // Calculate allowances (percentage of basic salary)
+    // Calculate allowances (percentage of basic salary, rounded to the cent)
     void calculateAllowances() {
-        double hra = basicSalary * 0.25;      // House Rent Allowance: 25%
-        double da = basicSalary * 0.15;       // Dearness Allowance: 15%
-        double ta = basicSalary * 0.10;       // Travel Allowance: 10%
-        double medical = basicSalary * 0.05;  // Medical Allowance: 5%
+        Money hra = basicSalary.scaledBy(25, 100);      // House Rent Allowance: 25%
+        Money da = basicSalary.scaledBy(15, 100);       // Dearness Allowance: 15%
+        Money ta = basicSalary.scaledBy(10, 100);       // Travel Allowance: 10%
+        Money medical = basicSalary.scaledBy(5, 100);   // Medical Allowance: 5%
         
         allowances = hra + da + ta + medical;
     }
 
-    // Calculate deductions (percentage of basic salary)
+    // Calculate deductions (percentage of basic salary, rounded to the cent)
     void calculateDeductions() {
-        double pf = basicSalary * 0.12;       // Provident Fund: 12%
-        double tax = basicSalary * 0.10;      // Income Tax: 10%
-        double insurance = basicSalary * 0.05; // Insurance: 5%
+        Money pf = basicSalary.scaledBy(12, 100);       // Provident Fund: 12%
+        Money tax = basicSalary.scaledBy(10, 100);      // Income Tax: 10%
+        Money insurance = basicSalary.scaledBy(5, 100); // Insurance: 5%
         
         deductions = pf + tax + insurance;
     }
@@ -118,48 +120,48 @@ public:
     
     // Display pay slip with detailed breakdown
     void displayPaySlip() const {
-        cout << "\n" << string(60, '=') << endl;
+        cout << "\n" << string(60, '=') << "\n";
         cout << "                 PAY SLIP\n";
-        cout << string(60, '=') << endl;
+        cout << string(60, '=') << "\n";
         
         // Get current date - FIXED: Correct time syntax
         time_t now = time(0);
         char* date = ctime(&now);
         
         cout << left << setw(20) << "Pay Slip Date:" << date;
-        cout << left << setw(20) << "Employee ID:" << empID << endl;
-        cout << left << setw(20) << "Employee Name:" << empName << endl;
-        cout << string(60, '-') << endl;
+        cout << left << setw(20) << "Employee ID:" << empID << "\n";
+        cout << left << setw(20) << "Employee Name:" << empName << "\n";
+        cout << string(60, '-') << "\n";
         
         // Earnings section
-        cout << "EARNINGS:" << endl;
+        cout << "EARNINGS:\n";
         cout << left << setw(30) << "  Basic Salary" 
-             << right << setw(20) << fixed << setprecision(2) << basicSalary << endl;
+             << right << setw(20) << basicSalary << "\n";
         cout << left << setw(30) << "  Allowances (Total)" 
-             << right << setw(20) << allowances << endl;
+             << right << setw(20) << allowances << "\n";
         cout << left << setw(30) << "  Gross Salary" 
-             << right << setw(20) << grossSalary << endl;
-        cout << string(60, '-') << endl;
+             << right << setw(20) << grossSalary << "\n";
+        cout << string(60, '-') << "\n";
         
         // Deductions section
-        cout << "DEDUCTIONS:" << endl;
+        cout << "DEDUCTIONS:\n";
         cout << left << setw(30) << "  Deductions (Total)" 
-             << right << setw(20) << deductions << endl;
-        cout << string(60, '-') << endl;
+             << right << setw(20) << deductions << "\n";
+        cout << string(60, '-') << "\n";
         
         // Net salary
         cout << left << setw(30) << "NET SALARY (Take Home)" 
-             << right << setw(20) << netSalary << endl;
-        cout << string(60, '=') << endl;
+             << right << setw(20) << netSalary << "\n";
+        cout << string(60, '=') << "\n";
     }
 
     // Display brief employee info
     void display() const {
         cout << left << setw(10) << empID 
              << setw(25) << empName 
-             << setw(15) << fixed << setprecision(2) << basicSalary
+             << setw(15) << basicSalary
              << setw(15) << grossSalary 
-             << setw(15) << netSalary << endl;
+             << setw(15) << netSalary << "\n";
     }
 };
 
@@ -184,7 +186,7 @@ public:
         
         int id;
         string name;
-        double basicSalary;
+        Money basicSalary;
         
         cout << "Enter Employee ID: ";
         cin >> id;
@@ -221,22 +223,26 @@ public:
             cout << "\nNo employees in the system.\n";
             return;
         }
+        ReportScope report;
+        if (report.suppressed()) {
+            return;  // Quiet mode - no report rendering
+        }
         
-        cout << "\n" << string(80, '=') << endl;
+        cout << "\n" << string(80, '=') << "\n";
         cout << "                      ALL EMPLOYEES\n";
-        cout << string(80, '=') << endl;
+        cout << string(80, '=') << "\n";
         cout << left << setw(10) << "ID" 
              << setw(25) << "Name" 
              << setw(15) << "Basic Salary"
              << setw(15) << "Gross Salary" 
-             << setw(15) << "Net Salary" << endl;
-        cout << string(80, '-') << endl;
+             << setw(15) << "Net Salary" << "\n";
+        cout << string(80, '-') << "\n";
         
         // ARRAY TRAVERSAL - Loop through all employees
         for (const auto& emp : employees) {
             emp.display();
         }
-        cout << string(80, '=') << endl;
+        cout << string(80, '=') << "\n";
         
         // Display statistics
         displayStatistics();
@@ -274,14 +280,19 @@ public:
             cout << "No employees for statistics.\n";
             return;
         }
+        ReportScope report;
+        if (report.suppressed()) {
+            return;  // Quiet mode - no report rendering
+        }
         
-        double totalBasic = 0, totalGross = 0, totalNet = 0;
-        double highestNet = 0, lowestNet = employees[0].getNetSalary();
+        // Integer-cent sums are exact, no rounding drift however many employees
+        Money totalBasic, totalGross, totalNet;
+        Money highestNet, lowestNet = employees[0].getNetSalary();
         string highestPaid, lowestPaid;
         
         // ARRAY PROCESSING - Calculate statistics
         for (const auto& emp : employees) {
-            double net = emp.getNetSalary();
+            Money net = emp.getNetSalary();
             totalBasic += emp.getBasicSalary();
             totalGross += emp.getGrossSalary();
             totalNet += net;
@@ -299,19 +310,19 @@ public:
             }
         }
         
-        double avgNet = totalNet / employees.size();
+        Money avgNet = totalNet / static_cast<int64_t>(employees.size());
         
-        cout << "\n" << string(50, '=') << endl;
+        cout << "\n" << string(50, '=') << "\n";
         cout << "          PAYROLL STATISTICS\n";
-        cout << string(50, '=') << endl;
-        cout << left << setw(30) << "Total Employees:" << employees.size() << endl;
-        cout << setw(30) << "Total Basic Salary:" << "$" << totalBasic << endl;
-        cout << setw(30) << "Total Gross Salary:" << "$" << totalGross << endl;
-        cout << setw(30) << "Total Net Salary:" << "$" << totalNet << endl;
-        cout << setw(30) << "Average Net Salary:" << "$" << fixed << setprecision(2) << avgNet << endl;
-        cout << setw(30) << "Highest Paid:" << highestPaid << " ($" << highestNet << ")" << endl;
-        cout << setw(30) << "Lowest Paid:" << lowestPaid << " ($" << lowestNet << ")" << endl;
-        cout << string(50, '=') << endl;
+        cout << string(50, '=') << "\n";
+        cout << left << setw(30) << "Total Employees:" << employees.size() << "\n";
+        cout << setw(30) << "Total Basic Salary:" << "$" << totalBasic << "\n";
+        cout << setw(30) << "Total Gross Salary:" << "$" << totalGross << "\n";
+        cout << setw(30) << "Total Net Salary:" << "$" << totalNet << "\n";
+        cout << setw(30) << "Average Net Salary:" << "$" << avgNet << "\n";
+        cout << setw(30) << "Highest Paid:" << highestPaid << " ($" << highestNet << ")\n";
+        cout << setw(30) << "Lowest Paid:" << lowestPaid << " ($" << lowestNet << ")\n";
+        cout << string(50, '=') << "\n";
     }
 
     // ============================================================
@@ -326,15 +337,15 @@ public:
         
         if (outFile.is_open()) {
             // Write number of employees first
-            outFile << employees.size() << endl;
+            outFile << employees.size() << "\n";
             
             // Write each employee's data
             for (const auto& emp : employees) {
-                outFile << emp.getID() << endl;
-                outFile << emp.getName() << endl;
-                outFile << emp.getBasicSalary() << endl;
-                outFile << emp.getGrossSalary() << endl;
-                outFile << emp.getNetSalary() << endl;
+                outFile << emp.getID() << "\n";
+                outFile << emp.getName() << "\n";
+                outFile << emp.getBasicSalary() << "\n";
+                outFile << emp.getGrossSalary() << "\n";
+                outFile << emp.getNetSalary() << "\n";
             }
             
             outFile.close();
@@ -360,7 +371,7 @@ public:
             for (int i = 0; i < numEmployees; i++) {
                 int id;
                 string name;
-                double basic, gross, net;
+                Money basic, gross, net;
                 
                 inFile >> id;
                 inFile.ignore();
@@ -396,17 +407,17 @@ public:
             char* timeStr = ctime(&now);
             
             // Write header
-            outFile << string(60, '=') << endl;
+            outFile << string(60, '=') << "\n";
             outFile << "             PAYROLL REPORT - ALL EMPLOYEES\n";
-            outFile << string(60, '=') << endl;
-            outFile << "Generated: " << timeStr << endl;
+            outFile << string(60, '=') << "\n";
+            outFile << "Generated: " << timeStr << "\n";
             
             // Write each employee's pay slip
             for (const auto& emp : employees) {
-                outFile << "\nEmployee ID: " << emp.getID() << endl;
-                outFile << "Name: " << emp.getName() << endl;
-                outFile << "Net Salary: $" << fixed << setprecision(2) << emp.getNetSalary() << endl;
-                outFile << string(40, '-') << endl;
+                outFile << "\nEmployee ID: " << emp.getID() << "\n";
+                outFile << "Name: " << emp.getName() << "\n";
+                outFile << "Net Salary: $" << emp.getNetSalary() << "\n";
+                outFile << string(40, '-') << "\n";
             }
             
             outFile.close();
@@ -422,9 +433,9 @@ public:
 
     // Function to display main menu
     void displayMenu() const {
-        cout << "\n" << string(50, '=') << endl;
+        cout << "\n" << string(50, '=') << "\n";
         cout << "     PAYROLL MANAGEMENT SYSTEM\n";
-        cout << string(50, '=') << endl;
+        cout << string(50, '=') << "\n";
         cout << "1. Add New Employee\n";
         cout << "2. Display All Employees\n";
         cout << "3. Display Employee Pay Slip\n";
@@ -433,7 +444,7 @@ public:
         cout << "6. Load Data from File\n";
         cout << "7. Export All Pay Slips\n";
         cout << "8. Exit System\n";
-        cout << string(50, '-') << endl;
+        cout << string(50, '-') << "\n";
         cout << "Enter your choice (1-8): ";
     }
 
@@ -449,17 +460,32 @@ public:
 // MAIN FUNCTION - Program Entry Point
 // Demonstrates: Program flow control, Object creation
 // ============================================================
-int main() {
+int main(int argc, char* argv[]) {
+    // Buffer all console output, flushed at prompts and on exit
+    BufferedConsole console;
+
+    // Command line options
+    for (int i = 1; i < argc; i++) {
+        string option = argv[i];
+        if (option == "--quiet") {
+            console.setQuiet(true);  // Skip report rendering
+        } else {
+            cout << "Unknown option: " << option << "\n";
+            cout << "Usage: ./main [--quiet]\n";
+            return 1;
+        }
+    }
+
     PayrollSystem payroll;  // Create PayrollSystem object
     int choice;
     
     // Load existing data when program starts
     payroll.loadFromFile();
     
-    cout << "\n" << string(60, '=') << endl;
+    cout << "\n" << string(60, '=') << "\n";
     cout << "  PAYROLL MANAGEMENT SYSTEM SIMULATION\n";
     cout << "   (Runs in VS Code - No Hardware Needed)\n";
-    cout << string(60, '=') << endl;
+    cout << string(60, '=') << "\n";
     
     // Main program loop
     do {